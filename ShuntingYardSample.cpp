@@ -4,7 +4,49 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include <string_view>
+#include <cctype>
+#include <climits>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <limits>
+#include <random>
 #include <sstream>
+#include <charconv>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SHUNTING_YARD_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Native code generation for hot compiled expressions
+#if defined(SHUNTING_YARD_HAS_MMAP) && (defined(__x86_64__) || defined(_M_X64)) && !defined(SHUNTING_YARD_NO_JIT)
+#define SHUNTING_YARD_HAS_JIT
+#endif
+
+// Coroutine-based asynchronous evaluation; only in C++20 builds
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define SHUNTING_YARD_HAS_COROUTINES
+#include <coroutine>
+#endif
 
 /* ====================================================================================
 	Description:	- Shunting-Yard algorithm is used to parse the expression & change it to
@@ -26,11 +68,191 @@
 	Last Modified:	8th March 2017
 =======================================================================================*/
 
+#pragma region Diagnostics
+/*	Enum:		Reason an expression failed to compile or evaluate
+*/
+enum class EvaluationError : unsigned char
+{
+	None,					// Success
+	EmptyExpression,		// No tokens to evaluate
+	InvalidToken,			// Character that is not part of the grammar
+	InvalidConstant,		// Integer literal that does not fit an int
+	MismatchedParenthesis,	// Closing bracket without an opening one, or vice versa
+	NotEnoughArguments,		// Operator without two values to work on
+	UnboundVariable,		// Variable read without any variable values supplied
+	DivisionByZero,			// Divisor evaluated to zero
+	NotCompiled,			// CompiledExpression that failed to compile was evaluated
+	CapacityExceeded,		// Expression needs more stack than a fixed-capacity evaluator has
+	Overflow,				// Result does not fit an overflow-checked value type
+	MissingOperator,		// Values left over with no operator to combine them, e.g. 1 2
+	UnknownFunction,		// Name called like a function that is neither built in nor registered
+	ArgumentCount,			// Function called with too few or too many arguments
+	NestingTooDeep,			// More operators, functions & brackets waiting at once than EvaluationLimits allow
+	TooManyTokens,			// More tokens than EvaluationLimits allow
+	ExpressionTooLong		// More characters than EvaluationLimits allow
+};
+
+/*	Struct:		- Outcome of compiling or evaluating an expression
+				- Converts to true on success, so callers can still write if (evaluate(...))
+*/
+struct EvaluationStatus
+{
+	EvaluationError error = EvaluationError::None;
+	unsigned int offset = 0;		// Character offset of the failing token in the expression
+
+	constexpr explicit operator bool() const { return error == EvaluationError::None; }
+};
+
+/*	Function:	Describe an error in words, for display to users
+	Parameters:	1) EvaluationError error	- Error to describe
+	Returns:	const char ptr - Static, null-terminated description
+*/
+const char* describeError(EvaluationError error)
+{
+	switch (error)
+	{
+		case EvaluationError::None:						return "Success";
+		case EvaluationError::EmptyExpression:			return "Empty expression";
+		case EvaluationError::InvalidToken:				return "Invalid token";
+		case EvaluationError::InvalidConstant:			return "Invalid constant";
+		case EvaluationError::MismatchedParenthesis:	return "Mismatched parenthesis";
+		case EvaluationError::NotEnoughArguments:		return "Not enough arguments";
+		case EvaluationError::UnboundVariable:			return "Unbound variable";
+		case EvaluationError::DivisionByZero:			return "Division by zero";
+		case EvaluationError::NotCompiled:				return "Expression not compiled";
+		case EvaluationError::CapacityExceeded:			return "Capacity exceeded";
+		case EvaluationError::Overflow:					return "Overflow";
+		case EvaluationError::MissingOperator:			return "Missing operator";
+		case EvaluationError::UnknownFunction:			return "Unknown function";
+		case EvaluationError::ArgumentCount:			return "Wrong number of arguments";
+		case EvaluationError::NestingTooDeep:			return "Nesting too deep";
+		case EvaluationError::TooManyTokens:			return "Too many tokens";
+		case EvaluationError::ExpressionTooLong:		return "Expression too long";
+	}
+
+	return "Unknown error";
+}
+
+/*	Logging hook
+	- Diagnostic messages are compiled out entirely unless SHUNTING_YARD_LOGGING is defined,
+		so evaluation never touches a stream by default
+	- When enabled, messages are passed to the hook set with setLogHook(); no hook means no output
+*/
+#ifdef SHUNTING_YARD_LOGGING
+typedef void (*LogHook)(const char* message);
+
+LogHook& logHook()
+{
+	static LogHook hook = nullptr;
+	return hook;
+}
+
+void setLogHook(LogHook hook)
+{
+	logHook() = hook;
+}
+
+#define SY_LOG(message) do { if (logHook() != nullptr) logHook()(message); } while (0)
+#else
+#define SY_LOG(message) ((void)0)
+#endif
+
+// Number of EvaluationError values; keep in step with the enum
+constexpr size_t evaluationErrorCount = static_cast<size_t>(EvaluationError::ExpressionTooLong) + 1;
+
+/*	Struct:		- Counters describing the work done through one EvaluationContext
+				- Only gathered when SHUNTING_YARD_STATS is defined; otherwise every counter stays 0
+					& the instrumentation compiles to nothing
+				- Tokenising & shunting run as one fused pass over the expression, so their
+					time is reported together as parseNanoseconds
+*/
+struct EvaluationStats
+{
+	unsigned long long evaluations = 0;				// Calls to evaluate()
+	unsigned long long compilations = 0;			// Calls to compile()
+	unsigned long long tokens = 0;					// Tokens lexed & shunted
+	unsigned long long instructions = 0;			// Postfix instructions calculated
+	unsigned long long parseNanoseconds = 0;		// Time spent tokenising & shunting
+	unsigned long long calculateNanoseconds = 0;	// Time spent calculating postfix programs
+	size_t maximumOperatorDepth = 0;				// Deepest operator stack seen while shunting
+	size_t maximumValueDepth = 0;					// Deepest value stack of any calculated program
+	unsigned long long bufferGrowths = 0;			// Times a scratch buffer had to allocate more room
+	unsigned long long failures[evaluationErrorCount] = {};	// Failed calls, indexed by EvaluationError
+
+	// Accumulate another set of counters into this one, e.g. from several threads
+	void add(const EvaluationStats& other)
+	{
+		evaluations += other.evaluations;
+		compilations += other.compilations;
+		tokens += other.tokens;
+		instructions += other.instructions;
+		parseNanoseconds += other.parseNanoseconds;
+		calculateNanoseconds += other.calculateNanoseconds;
+		maximumOperatorDepth = std::max(maximumOperatorDepth, other.maximumOperatorDepth);
+		maximumValueDepth = std::max(maximumValueDepth, other.maximumValueDepth);
+		bufferGrowths += other.bufferGrowths;
+
+		for (size_t i = 0; i < evaluationErrorCount; i++)
+		{
+			failures[i] += other.failures[i];
+		}
+	}
+};
+
+/*	Instrumentation
+	- SY_STATS(statements) only compiles its statements when SHUNTING_YARD_STATS is defined
+	- SY_STATS_LOCAL(type, name, value) likewise declares a local for later SY_STATS statements
+*/
+#ifdef SHUNTING_YARD_STATS
+#define SY_STATS(...) do { __VA_ARGS__; } while (0)
+#define SY_STATS_LOCAL(type, name, value) type name = value
+
+/*	Function:	Nanoseconds since the given time
+	Parameters:	1) time_point start	- Time the measured stage began
+	Returns:	unsigned long long
+*/
+inline unsigned long long elapsedNanoseconds(std::chrono::steady_clock::time_point start)
+{
+	return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - start).count());
+}
+#else
+#define SY_STATS(...) ((void)0)
+#define SY_STATS_LOCAL(type, name, value) ((void)0)
+#endif
+#pragma endregion
+
 // Method declarations
 bool isOperator(const std::string& token);
 bool verifyInteger(const std::string& token);
 bool isParenthesis(const std::string& token);
-bool evaluate(const std::string& expression, int &result);
+EvaluationStatus evaluate(const std::string& expression, int &result);
+
+class CompiledExpression;
+EvaluationStatus compile(std::string_view expression, CompiledExpression& compiled);
+EvaluationStatus evaluate(const CompiledExpression& compiled, int& result);
+EvaluationStatus evaluate(const CompiledExpression& compiled, const int* variables, int& result);
+
+class EvaluationContext;
+EvaluationStatus evaluate(std::string_view expression, EvaluationContext& context, int& result);
+EvaluationStatus evaluate(const CompiledExpression& compiled, EvaluationContext& context, int& result);
+EvaluationStatus evaluate(const CompiledExpression& compiled, const int* variables, EvaluationContext& context, int& result);
+EvaluationStatus evaluateBatch(const CompiledExpression& compiled, const int* const* columns, size_t rowCount, int* results, EvaluationStatus* statuses);
+EvaluationStatus evaluateBatch(const CompiledExpression& compiled, const int* const* columns, size_t rowCount, int* results, EvaluationStatus* statuses, EvaluationContext& context);
+void setJitThreshold(unsigned int evaluationCount);
+
+struct EvaluationLimits;
+void setEvaluationLimits(const EvaluationLimits& limits);
+
+template <typename Value> class TypedExpression;
+template <typename Value> EvaluationStatus compile(std::string_view expression, TypedExpression<Value>& compiled);
+template <typename Value> EvaluationStatus evaluateAs(std::string_view expression, Value& result);
+EvaluationStatus evaluateStream(std::istream& input, int& result);
+
+class ProgramFile;
+bool saveProgramFile(const char* path, const CompiledExpression* expressions, size_t count);
+EvaluationStatus evaluate(const ProgramFile& file, size_t index, const int* variables, EvaluationContext& context, int& result);
+EvaluationStatus evaluate(const ProgramFile& file, size_t index, const int* variables, int& result);
 
 #pragma region Global Methods
 /*	Function:	Verify if a given token is an arithmetic operator
@@ -84,396 +306,8990 @@ bool verifyInteger(const std::string& token)
 
 	return isInteger;
 }
-#pragma endregion
 
-#pragma region Shunting Yard Algorithm
-class ShuntingYard
+/*	Function:	- Counter bumped whenever the same text may start compiling differently: new
+					evaluation limits or a newly registered function, so caches of compiled text
+					know to drop their entries
+				- Bumped with release order after the change is made, so a reader that loads it
+					with acquire order before compiling sees the change or a later bump
+	Returns:	atomic<unsigned long long> ref
+*/
+std::atomic<unsigned long long>& compilationGeneration()
 {
-	// Public declarations
-	public:
-		bool shuntInfixToRPN(const std::vector<std::string>& inputTokens, std::vector<std::string>& returnArray);
+	static std::atomic<unsigned long long> generation{ 0 };
+	return generation;
+}
+#pragma endregion
 
-	private:
-		// Declare operator stack
-		// Stores arithmetic operators
-		std::stack<std::string> operatorStack;
+#pragma region Bytecode
+/*	Enum:		- Operation performed by a single compiled instruction
+				- Stored as a single byte to keep instructions compact
+*/
+enum class OpCode : unsigned char
+{
+	PushConstant,			// Push the inline operand onto the value stack
+	PushVariable,			// Push the variable at index operand onto the value stack
+	PushLiteral,			// Push entry operand of the program's literal table; used by typed programs
+	Add,					// Pop two values, push their sum
+	Subtract,				// Pop two values, push their difference
+	Multiply,				// Pop two values, push their product
+	Divide,					// Pop two values, push their quotient
+	Negate,					// Pop one value, push its negation
+	Minimum,				// Pop two values, push the smaller
+	Maximum,				// Pop two values, push the larger
+	Absolute,				// Pop one value, push its magnitude
+	Call					// Pop callArity(operand) values, push the result of registered function
+							//		callFunction(operand) applied to them
+};
+// OpCode values are stored in program files; add new opcodes at the end & bump programFileVersion
 
-		// Declare output queue
-		// Stores RPN output
-		std::queue<std::string> outputQueue;
+/*	Struct:		- A single instruction of a compiled postfix program
+				- Integer constants are stored inline so evaluation never has to
+					parse or compare strings
+				- Programs are stored contiguously as std::vector<Instruction>
+*/
+struct Instruction
+{
+	OpCode opCode;			// Operation to perform
+	int operand;			// Constant value for PushConstant, variable index for PushVariable,
+							//		function & arity for Call (see callOperand); unused otherwise
 };
 
-/*	Function:	- Implementation of the Shunting-Yard algorithm
-				- Convert infix notation to postfix (RPN)
-	Parameters: 1) Vector<string> ref inputTokens	- Reference to the tokens to convert
-				2) Vector<string ref returnArray	- Reference to the collection of postfix tokens
-													- Pass-by-reference used to directly modify the
-														stored collection without having to return a value & 
-														allow the method to return true/false for a successful conversion
-	Returns: 1) bool	- Whether or not the conversion was successful
+/*	Functions:	Pack & unpack the operand of a Call instruction
+				- The arity travels with the instruction, so stack depths can be checked
+					without consulting the function registry
+	Parameters:	1) unsigned int function	- Index of the registered function
+				2) unsigned int arity		- Number of arguments; at most 255
+	Returns:	int / unsigned int
 */
-bool ShuntingYard::shuntInfixToRPN(const std::vector<std::string>& inputTokens, std::vector<std::string>& returnArray)
+constexpr int callOperand(unsigned int function, unsigned int arity) { return static_cast<int>((function << 8) | arity); }
+constexpr unsigned int callFunction(int operand) { return static_cast<unsigned int>(operand) >> 8; }
+constexpr unsigned int callArity(int operand) { return static_cast<unsigned int>(operand) & 0xFF; }
+
+/*	Functions:	- Two's complement wrapping arithmetic over a signed integer type
+				- Done in the matching unsigned type, where overflow is defined, so the
+					minimum value negates to itself & MIN / -1 (which traps in hardware)
+					wraps to MIN the same way
+				- wrappingDivide expects a nonzero divisor; see divideIntegers
+	Parameters:	1) Integer lhs	- Left-hand operand; the only operand of wrappingNegate
+				2) Integer rhs	- Right-hand operand
+	Returns:	Integer
+*/
+template <typename Integer>
+constexpr Integer wrappingAdd(Integer lhs, Integer rhs)
 {
-	// Iterate through tokens
-	for (unsigned int i = 0; i < inputTokens.size(); i++)
+	return static_cast<Integer>(static_cast<std::make_unsigned_t<Integer>>(lhs) + static_cast<std::make_unsigned_t<Integer>>(rhs));
+}
+
+template <typename Integer>
+constexpr Integer wrappingSubtract(Integer lhs, Integer rhs)
+{
+	return static_cast<Integer>(static_cast<std::make_unsigned_t<Integer>>(lhs) - static_cast<std::make_unsigned_t<Integer>>(rhs));
+}
+
+template <typename Integer>
+constexpr Integer wrappingMultiply(Integer lhs, Integer rhs)
+{
+	return static_cast<Integer>(static_cast<std::make_unsigned_t<Integer>>(lhs) * static_cast<std::make_unsigned_t<Integer>>(rhs));
+}
+
+template <typename Integer>
+constexpr Integer wrappingNegate(Integer lhs)
+{
+	return static_cast<Integer>(std::make_unsigned_t<Integer>(0) - static_cast<std::make_unsigned_t<Integer>>(lhs));
+}
+
+template <typename Integer>
+constexpr Integer wrappingDivide(Integer lhs, Integer rhs)
+{
+	return rhs == -1 ? wrappingNegate(lhs) : lhs / rhs;
+}
+
+/*	Function:	- Divide, reporting a zero divisor rather than trapping
+				- The one guarded division shared by every integer evaluator
+	Parameters:	1) Integer lhs			- Dividend
+				2) Integer rhs			- Divisor
+				3) Integer ref value	- Receives the quotient; may alias lhs
+	Returns:	EvaluationError - DivisionByZero if rhs is 0, None otherwise
+*/
+template <typename Integer>
+constexpr EvaluationError divideIntegers(Integer lhs, Integer rhs, Integer& value)
+{
+	if (rhs == 0)
 	{
-		const std::string currentToken = inputTokens[i];				// Cache the current token to check
-		
-		// Check if token is a number
-		if (verifyInteger(currentToken))
-		{
-			// Push number to output queue
-			outputQueue.push(currentToken);
-		}
+		return EvaluationError::DivisionByZero;
+	}
 
-		// Check if token is an operator
-		else if (isOperator(currentToken))
-		{
-			// Push to operator stack
-			operatorStack.push(currentToken);
-		}
+	value = wrappingDivide(lhs, rhs);
+	return EvaluationError::None;
+}
 
-		// Check if token is left bracket
-		else if (currentToken == "(")
-		{
-			// Push to operator stack
-			operatorStack.push(currentToken);
-		}
+/*	Functions:	- Arithmetic performed by each operator
+				- Wraps on overflow, so every int evaluator has defined behaviour
+				- divideValues expects a nonzero divisor; evaluators divide through divideIntegers
+	Parameters:	1) int lhs	- Left-hand operand; the only operand of unary operators
+				2) int rhs	- Right-hand operand; unused by unary operators
+	Returns:	int
+*/
+constexpr int addValues(int lhs, int rhs) { return wrappingAdd(lhs, rhs); }
+constexpr int subtractValues(int lhs, int rhs) { return wrappingSubtract(lhs, rhs); }
+constexpr int multiplyValues(int lhs, int rhs) { return wrappingMultiply(lhs, rhs); }
+constexpr int divideValues(int lhs, int rhs) { return wrappingDivide(lhs, rhs); }
+constexpr int negateValue(int lhs, int) { return wrappingNegate(lhs); }
+constexpr int minimumValue(int lhs, int rhs) { return lhs < rhs ? lhs : rhs; }
+constexpr int maximumValue(int lhs, int rhs) { return lhs < rhs ? rhs : lhs; }
+constexpr int absoluteValue(int lhs, int) { return lhs < 0 ? negateValue(lhs, 0) : lhs; }
 
-		// Check if token is right bracket
-		else if (currentToken == ")")
-		{
-			// Cache the initial top token of the operator stack
-			std::string topOperatorStackToken = operatorStack.top();
+/*	Enum:		Side an operator groups from when chained with operators of equal precedence
+*/
+enum class Associativity : unsigned char
+{
+	Left,					// a - b - c == ( a - b ) - c
+	Right					// - - a == - ( - a )
+};
 
-			// Until the token at the top of the stack is a left parenthesis, 
-			//		pop operators off the stack onto the output queue
-			// When the loop exits either the stack will be empty,
-			//		or the left parenthesis will be found
-			// When left parenthesis is found it can be popped off the stack,
-			//		assuming the stack is not empty
-			while (topOperatorStackToken != "(")
-			{
-				outputQueue.push(topOperatorStackToken);
-				operatorStack.pop();
+/*	Struct:		Everything the Shunting-Yard & interpreters need to know about an operator
+*/
+struct OperatorInfo
+{
+	char symbol;					// Character the operator is written as
+	unsigned char precedence;		// Higher binds tighter
+	Associativity associativity;	// Grouping among equal precedence
+	unsigned char arity;			// 1 for prefix operators, 2 for infix operators
+	OpCode opCode;					// Instruction the operator compiles to
+	int (*apply)(int, int);			// Arithmetic, for callers dispatching on the table
+};
 
-				// If the stack is emptied break the loop
-				if (operatorStack.empty())
-					break;
+/*	Operator table
+	- Built at compile time; adding an operator only needs a row here & an OpCode
+	- '-' appears twice; which row applies depends on whether an operand or an
+		operator is expected when it is read
+*/
+constexpr OperatorInfo operatorTable[] =
+{
+	{ '+', 1, Associativity::Left, 2, OpCode::Add, addValues },
+	{ '-', 1, Associativity::Left, 2, OpCode::Subtract, subtractValues },
+	{ '*', 2, Associativity::Left, 2, OpCode::Multiply, multiplyValues },
+	{ '/', 2, Associativity::Left, 2, OpCode::Divide, divideValues },
+	{ '-', 3, Associativity::Right, 1, OpCode::Negate, negateValue }
+};
 
-				// Get new top token from operator stack
-				// Cache it for future reference
-				topOperatorStackToken = operatorStack.top();
-			} // End while() loop; Checking for left bracket
+constexpr size_t operatorCount = sizeof(operatorTable) / sizeof(operatorTable[0]);
 
-			// Pop & discard the left bracket from the stack
-			if (!operatorStack.empty())
-				operatorStack.pop();
+// Marks characters that are not operators of the requested arity
+constexpr unsigned char noOperator = 0xFF;
 
-			// If the stack is empty & we never found the left bracket
-			// There was a syntax error; missing bracket
-			if (topOperatorStackToken != "(")
-			{
-				std::cout << "Failure Point: Mismatched parenthesis \n";
-				return false;
-			}	
-		}
+/*	Struct:		- Character to operator table index lookup, indexed by unsigned char
+				- One lookup per arity, so both uses of '-' resolve with a single index
+				- Also holds the arity of every OpCode, indexed by its value, as verifying
+					& executing programs look it up once per instruction
+*/
+struct OperatorLookup
+{
+	unsigned char binary[256];
+	unsigned char unary[256];
+	unsigned char arity[256];
+};
 
-		// Otherwise, an invalid non-operator, non-integer token is present,
-		//		that is also not the null terminator
-		else if (currentToken != "\0")
-		{
-			std::cout << "Failure Point: Default condition \n";
-			std::cout << currentToken;
-			return false;
-			
-		}
-	} // End for() loop; token iteration
+/*	Function:	Build the character lookup from the operator table at compile time
+	Returns:	OperatorLookup
+*/
+constexpr OperatorLookup buildOperatorLookup()
+{
+	OperatorLookup lookup = {};
 
-	  // While there are still tokens in the operator stack
-	  //		clear the operator stack and finalise the output queue
-	while (!operatorStack.empty())
+	for (size_t i = 0; i < 256; i++)
 	{
-		const std::string topOperatorStackToken = operatorStack.top();
-
-		// If the operator on the top of the stack is a parenthesis,
-		//		then there are mismatched parenthesis
-		if (isParenthesis(topOperatorStackToken))
-		{
-			std::cout << "Failure Point: mismatched parenthesis";
-			return false;
-		}
-			
-		// Pop the operator onto the output queue
-		outputQueue.push(topOperatorStackToken);
-		operatorStack.pop();
-	} // End while() loop; clear operator stack
+		lookup.binary[i] = noOperator;
+		lookup.unary[i] = noOperator;
+	}
 
-	// Copy output queue contents to the return array
-	while (!outputQueue.empty())
+	for (size_t i = 0; i < operatorCount; i++)
 	{
-		// Add front element of output queue to
-		//		the back of the return array
-		returnArray.push_back(outputQueue.front());
+		const unsigned char symbol = static_cast<unsigned char>(operatorTable[i].symbol);
 
-		// Pop front off of output queue
-		outputQueue.pop();
-	} // End while() loop; copying  output queue
+		if (operatorTable[i].arity == 2)
+			lookup.binary[symbol] = static_cast<unsigned char>(i);
+		else
+			lookup.unary[symbol] = static_cast<unsigned char>(i);
 
-	return true;
+		lookup.arity[static_cast<unsigned char>(operatorTable[i].opCode)] = operatorTable[i].arity;
+	}
+
+	// Operators only reachable through function calls
+	lookup.arity[static_cast<unsigned char>(OpCode::Minimum)] = 2;
+	lookup.arity[static_cast<unsigned char>(OpCode::Maximum)] = 2;
+	lookup.arity[static_cast<unsigned char>(OpCode::Absolute)] = 1;
+
+	return lookup;
 }
-#pragma endregion
 
-#pragma region RPN Calculation
-class RPN
+constexpr OperatorLookup operatorLookup = buildOperatorLookup();
+
+/*	Function:	Table index of the infix or prefix operator written as the given character
+	Parameters:	1) char symbol	- Character to look up
+	Returns:	unsigned char - Index into operatorTable, or noOperator
+*/
+constexpr unsigned char binaryOperatorIndex(char symbol) { return operatorLookup.binary[static_cast<unsigned char>(symbol)]; }
+constexpr unsigned char unaryOperatorIndex(char symbol) { return operatorLookup.unary[static_cast<unsigned char>(symbol)]; }
+
+/*	Function:	Number of values an instruction pops off the value stack
+	Parameters:	1) OpCode opCode	- Instruction to look up
+	Returns:	unsigned char - 0 for pushes, otherwise the operator's arity
+				- Call pops a varying number of values; use instructionArity for it
+*/
+constexpr unsigned char opCodeArity(OpCode opCode) { return operatorLookup.arity[static_cast<unsigned char>(opCode)]; }
+
+/*	Function:	Number of values an instruction pops off the value stack, including calls
+	Parameters:	1) Instruction ref instruction	- Instruction to look up
+	Returns:	unsigned char - 0 for pushes, otherwise the number of operands
+*/
+constexpr unsigned char instructionArity(const Instruction& instruction)
 {
-	public:
-		bool calculatePostfix(const std::vector<std::string>& inputTokens, int& result);
+	return instruction.opCode == OpCode::Call ? static_cast<unsigned char>(callArity(instruction.operand))
+		: opCodeArity(instruction.opCode);
+}
 
-	private:
-		std::stack<int> valueStack;		// Holds values for Postfix calculations
-};
+static_assert(binaryOperatorIndex('*') == 2, "Operator lookup must index the operator table");
+static_assert(opCodeArity(OpCode::Negate) == 1 && opCodeArity(OpCode::PushConstant) == 0, "Arity lookup");
+static_assert(instructionArity({ OpCode::Call, callOperand(7, 3) }) == 3 && callFunction(callOperand(7, 3)) == 7, "Call operands");
 
-/*	Function:	Calculate the result of an expression written in postfix notation
-	Parameters:	1) Vector<string> ref inputTokens	- Reference to collection of postfix-ordered tokens
-				2) int ref result					- Reference to the variable for storing results
-													- Pass-by-reference used to directly modify the
-														result value to be displayed withotu having to return
-														a value & allows the method to return true/false for
-														a successfuly calculation
-	Returns: 1) bool	- Whether or not the calculation was successful
+/*	Function:	- Apply a binary operator to the two values on top of the value stack
+				- Shared by every interpreter so they agree on operand order
+				- Switches over the OpCode so each operator's arithmetic is inlined
+	Parameters:	1) OpCode opCode	- Operator to apply
+				2) int lhs			- Value beneath the top of the stack (pushed first)
+				3) int rhs			- Value on top of the stack (pushed last)
+				4) int ref value	- Receives the result; may alias lhs's slot
+	Returns:	EvaluationError - None on success
 */
-bool RPN::calculatePostfix(const std::vector<std::string>& inputTokens, int& result)
+constexpr EvaluationError applyOperator(OpCode opCode, int lhs, int rhs, int& value)
 {
-	// Iterate over each given input token
-	// Integer checked first as we know the integers are,
-	//		ordered before operators thanks to Shunting Yard
-	for (int i = 0; i < inputTokens.size(); i++)
+	switch (opCode)
 	{
-		const std::string currentToken = inputTokens[i];					// Cache the current token
+		case OpCode::Add:		value = addValues(lhs, rhs); return EvaluationError::None;
+		case OpCode::Subtract:	value = subtractValues(lhs, rhs); return EvaluationError::None;
+		case OpCode::Multiply:	value = multiplyValues(lhs, rhs); return EvaluationError::None;
+		case OpCode::Minimum:	value = minimumValue(lhs, rhs); return EvaluationError::None;
+		case OpCode::Maximum:	value = maximumValue(lhs, rhs); return EvaluationError::None;
 
-		// Check if token is integer
-		if (verifyInteger(currentToken))
-		{
-			// Convert string to integer,
-			//		push to stack of values
-			valueStack.push(std::stoi(currentToken));
-		}
+		case OpCode::Divide:	return divideIntegers(lhs, rhs, value);
 
-		// Check if token is an operator
-		else if (isOperator(currentToken))
-		{
-			// All operators require two arguements
-			// Check if there are enough values on the stack
+		default:
+			SY_LOG("Invalid expression. Returning 0.");
+			return EvaluationError::InvalidToken;
+	}
+}
 
-			// If there is one value left on the stack,
-			//		it is returned as the result
-			if (valueStack.size() == 1)
-			{
-				result = valueStack.top();
-				valueStack.pop();
+/*	Function:	- Measure the deepest value stack a program can reach
+				- Used to size value stacks & column blocks up front
+	Parameters:	1) Instruction ptr program		- Pointer to the first instruction
+				2) size_t instructionCount		- Number of instructions in the program
+	Returns:	size_t - Maximum number of values held at once
+*/
+size_t measureStackDepth(const Instruction* program, size_t instructionCount)
+{
+	size_t depth = 0;
+	size_t maximumDepth = 0;
 
-				return true;
-			}
+	for (size_t i = 0; i < instructionCount; i++)
+	{
+		// Every instruction pops its operands & pushes one value
+		const unsigned char arity = instructionArity(program[i]);
+		depth = (depth > arity ? depth - arity : 0) + 1;
 
+		if (depth > maximumDepth)
+		{
+			maximumDepth = depth;
+		}
+	}
+
+	return maximumDepth;
+}
+
+/*	Function:	- Verify a postfix program before it is ever run
+				- Tracks the exact stack depth at each instruction, rejecting programs where an
+					operator would find too few operands or that leave more than one value
+				- Every program produced by ShuntingYard::shuntInfixToRPN has been verified, so
+					interpreters can run them without any stack bounds checks
+	Parameters:	1) Instruction ptr program		- Pointer to the first instruction
+				2) size_t instructionCount		- Number of instructions in the program
+	Returns:	EvaluationStatus - NotEnoughArguments at the first operator that underflows, or
+									MissingOperator at the start of the first superfluous value;
+									offset holds an instruction index
+*/
+EvaluationStatus verifyProgram(const Instruction* program, size_t instructionCount)
+{
+	EvaluationStatus status;
+	size_t depth = 0;
+	size_t secondValueStart = 0;	// First instruction of the value second from the bottom
+
+	for (size_t i = 0; i < instructionCount; i++)
+	{
+		const unsigned char arity = instructionArity(program[i]);
+
+		if (depth < arity)
+		{
+			status.error = EvaluationError::NotEnoughArguments;
+			status.offset = static_cast<unsigned int>(i);
+			return status;
+		}
+
+		depth = depth - arity + 1;
+
+		if (arity == 0 && depth == 2)
+		{
+			secondValueStart = i;
+		}
+	}
+
+	if (depth == 0)
+	{
+		status.error = EvaluationError::EmptyExpression;
+	}
+
+	else if (depth > 1)
+	{
+		status.error = EvaluationError::MissingOperator;
+		status.offset = static_cast<unsigned int>(secondValueStart);
+	}
+
+	return status;
+}
+#pragma endregion
+
+#pragma region Lexer
+/*	Enum:		Category of a lexed token
+*/
+enum class TokenKind : unsigned char
+{
+	Number,					// A digit followed by digits & decimal points
+	Variable,				// A letter or underscore followed by letters, digits or underscores
+	Operator,				// Any symbol in operatorTable
+	LeftParenthesis,		// (
+	RightParenthesis,		// )
+	Separator,				// , between function arguments
+	Function,				// A variable token naming a function; only ever made by the shunt
+	Invalid					// Any other character
+};
+
+/*	Struct:		- A single token of an expression
+				- Refers back into the caller's buffer by offset & length,
+					so no characters are ever copied
+*/
+struct Token
+{
+	TokenKind kind;
+	unsigned int offset;	// Offset of the first character in the expression
+	unsigned int length;	// Number of characters in the token
+};
+
+/*	Functions:	- Character classes of the grammar, as the "C" locale defines them
+				- constexpr, unlike <cctype>, so the lexer also runs at compile time
+	Parameters:	1) char character	- Character to classify
+	Returns:	bool
+*/
+constexpr bool isSpaceCharacter(char character) { return character == ' ' || (character >= '\t' && character <= '\r'); }
+constexpr bool isDigitCharacter(char character) { return character >= '0' && character <= '9'; }
+constexpr bool isNumberCharacter(char character) { return isDigitCharacter(character) || character == '.'; }
+constexpr bool isIdentifierStart(char character)
+{
+	return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z') || character == '_';
+}
+constexpr bool isIdentifierCharacter(char character) { return isIdentifierStart(character) || isDigitCharacter(character); }
+
+/*	Class:		- Single-pass, allocation-free tokeniser over a std::string_view
+				- Whitespace between tokens is optional, so both "4 + ( 12 / 2 )"
+					and "4+(12/2)" are accepted
+				- The viewed buffer must outlive the lexer
+				- Usable in constant expressions
+*/
+class Lexer
+{
+	public:
+		constexpr explicit Lexer(std::string_view expression) : source(expression) {}
+
+		constexpr bool next(Token& token);
+
+		// Characters making up the given token
+		constexpr std::string_view text(const Token& token) const { return source.substr(token.offset, token.length); }
+
+	private:
+		std::string_view source;		// Expression being tokenised
+		size_t position = 0;			// Offset of the next unread character
+};
+
+/*	Function:	Read the next token of the expression
+	Parameters:	1) Token ref token	- Reference to the token to fill in
+	Returns:	bool - True if a token was read, false once the end of the expression is reached
+*/
+constexpr bool Lexer::next(Token& token)
+{
+	// Skip any whitespace before the token
+	while (position < source.size() && isSpaceCharacter(source[position]))
+	{
+		position++;
+	}
+
+	if (position >= source.size())
+	{
+		return false;
+	}
+
+	const size_t start = position;
+	const char current = source[position++];
+
+	if (isDigitCharacter(current))
+	{
+		// Numbers may have multiple digits & a fractional part; consume them all
+		// Whether the characters form a valid constant is up to the value type
+		while (position < source.size() && isNumberCharacter(source[position]))
+		{
+			position++;
+		}
+
+		token.kind = TokenKind::Number;
+	}
+
+	else if (isIdentifierStart(current))
+	{
+		// Variable names may contain digits after the first character
+		while (position < source.size() && isIdentifierCharacter(source[position]))
+		{
+			position++;
+		}
+
+		token.kind = TokenKind::Variable;
+	}
+
+	else if (binaryOperatorIndex(current) != noOperator || unaryOperatorIndex(current) != noOperator)
+		token.kind = TokenKind::Operator;
+
+	else if (current == '(')
+		token.kind = TokenKind::LeftParenthesis;
+
+	else if (current == ')')
+		token.kind = TokenKind::RightParenthesis;
+
+	else if (current == ',')
+		token.kind = TokenKind::Separator;
+
+	else
+		token.kind = TokenKind::Invalid;
+
+	token.offset = static_cast<unsigned int>(start);
+	token.length = static_cast<unsigned int>(position - start);
+	return true;
+}
+
+/*	Function:	Convert the digits of a number token to an integer
+	Parameters:	1) string_view digits	- Characters of the number token
+				2) int ref value		- Reference to the variable for storing the value
+	Returns:	bool - Whether or not the number is a whole number that fits in an int
+*/
+constexpr bool parseInteger(std::string_view digits, int& value)
+{
+	long long accumulated = 0;
+
+	for (size_t i = 0; i < digits.size(); i++)
+	{
+		if (!isDigitCharacter(digits[i]))
+		{
+			return false;
+		}
+
+		accumulated = accumulated * 10 + (digits[i] - '0');
+
+		if (accumulated > INT_MAX)
+		{
+			return false;
+		}
+	}
+
+	value = static_cast<int>(accumulated);
+	return true;
+}
+#pragma endregion
+
+#pragma region Functions
+/*	Function calls
+	- A name followed by a bracketed, comma-separated argument list, e.g. max ( a , b , 0 )
+	- Built-in functions compile to inline instructions rather than calls: min & max fold
+		their arguments pairwise, abs is a single instruction & clamp ( x , lo , hi ) is
+		min ( max ( x , lo ) , hi )
+	- Registered functions compile to a Call instruction holding the function's registry
+		index, so evaluation calls straight through a table entry without any name lookup
+	- Function names are reserved; they cannot also be used as variables
+*/
+
+// Placeholder in FunctionInfo::afterArgument for arguments that emit nothing
+constexpr OpCode noStep = OpCode::PushConstant;
+
+// Marks names that are not functions
+constexpr unsigned int noFunction = UINT_MAX;
+
+// Most arguments a function call may have, bounded by the arity bits of a Call operand
+constexpr unsigned int maximumFunctionArguments = 255;
+
+/*	Struct:		- How a built-in function compiles
+				- Each argument is shunted in place; once argument i is complete the
+					instruction afterArgument[min(i, 2)] is emitted, unless it is noStep
+*/
+struct FunctionInfo
+{
+	std::string_view name;				// Name the function is called by
+	unsigned char minimumArguments;		// Fewest arguments accepted
+	unsigned char maximumArguments;		// Most arguments accepted
+	OpCode afterArgument[3];			// Instruction following the first, second & every later argument
+};
+
+constexpr FunctionInfo builtinFunctions[] =
+{
+	{ "abs", 1, 1, { OpCode::Absolute, noStep, noStep } },
+	{ "min", 1, maximumFunctionArguments, { noStep, OpCode::Minimum, OpCode::Minimum } },
+	{ "max", 1, maximumFunctionArguments, { noStep, OpCode::Maximum, OpCode::Maximum } },
+	{ "clamp", 3, 3, { noStep, OpCode::Maximum, OpCode::Minimum } }
+};
+
+constexpr unsigned int builtinFunctionCount = sizeof(builtinFunctions) / sizeof(builtinFunctions[0]);
+
+/*	Function:	Find a built-in function by name
+	Parameters:	1) string_view name	- Name of the function
+	Returns:	unsigned int - Index into builtinFunctions, or noFunction
+*/
+constexpr unsigned int findBuiltinFunction(std::string_view name)
+{
+	for (unsigned int i = 0; i < builtinFunctionCount; i++)
+	{
+		if (builtinFunctions[i].name == name)
+		{
+			return i;
+		}
+	}
+
+	return noFunction;
+}
+
+/*	Function:	Instruction emitted once an argument of a built-in function is complete
+	Parameters:	1) FunctionInfo ref function	- Function being called
+				2) size_t argument				- Index of the completed argument
+	Returns:	OpCode - Instruction to emit, or noStep
+*/
+constexpr OpCode argumentStep(const FunctionInfo& function, size_t argument)
+{
+	return function.afterArgument[argument < 2 ? argument : 2];
+}
+
+static_assert(findBuiltinFunction("clamp") == 3 && findBuiltinFunction("sqrt") == noFunction, "Built-in function lookup");
+
+/*	Typedef:	- A registered function
+				- Receives its arguments in call order & stores its value in result
+				- Returning an error fails the evaluation at the call; the function must be
+					safe to call from many threads at once
+*/
+typedef EvaluationError (*UserFunction)(const int* arguments, int& result);
+
+// Most functions that can be registered; entries are never removed, so their indices stay valid
+constexpr size_t maximumRegisteredFunctions = 256;
+
+/*	Struct:		- Every registered function, indexed by Call operands
+				- Registration appends under a lock & then publishes the new count, so
+					readers (shunting & evaluation) never lock
+*/
+struct FunctionRegistry
+{
+	struct Entry
+	{
+		std::string name;				// Name the function is called by
+		unsigned int arity = 0;			// Number of arguments it takes
+		UserFunction function = nullptr;
+	};
+
+	Entry entries[maximumRegisteredFunctions];
+	std::atomic<size_t> count{ 0 };		// Entries published so far
+	std::mutex registration;			// Serialises registerFunction
+};
+
+/*	Function:	The process-wide function registry
+	Returns:	FunctionRegistry ref
+*/
+FunctionRegistry& functionRegistry()
+{
+	static FunctionRegistry registry;
+	return registry;
+}
+
+/*	Function:	Find a registered function by name
+	Parameters:	1) string_view name	- Name of the function
+	Returns:	unsigned int - Registry index, or noFunction
+*/
+unsigned int findRegisteredFunction(std::string_view name)
+{
+	const FunctionRegistry& registry = functionRegistry();
+	const size_t count = registry.count.load(std::memory_order_acquire);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (registry.entries[i].name == name)
+		{
+			return static_cast<unsigned int>(i);
+		}
+	}
+
+	return noFunction;
+}
+
+/*	Function:	- Register a function that expressions can call by name
+				- Only affects expressions compiled afterwards; bumps compilationGeneration(), so
+					text that ExpressionCache holds as an UnknownFunction failure is compiled again
+	Parameters:	1) string_view name				- Name to call the function by; must be an identifier
+				2) unsigned int arity			- Number of arguments it takes, at most maximumFunctionArguments
+				3) UserFunction function		- Function to call
+	Returns:	bool - False if the name is invalid or taken, the arity too large, or the registry full
+*/
+bool registerFunction(std::string_view name, unsigned int arity, UserFunction function)
+{
+	if (name.empty() || !isIdentifierStart(name[0]) || arity > maximumFunctionArguments || function == nullptr
+		|| !std::all_of(name.begin(), name.end(), isIdentifierCharacter) || findBuiltinFunction(name) != noFunction)
+	{
+		return false;
+	}
+
+	FunctionRegistry& registry = functionRegistry();
+	std::lock_guard<std::mutex> lock(registry.registration);
+	const size_t count = registry.count.load(std::memory_order_relaxed);
+
+	if (count == maximumRegisteredFunctions || findRegisteredFunction(name) != noFunction)
+	{
+		return false;
+	}
+
+	registry.entries[count].name.assign(name.data(), name.size());
+	registry.entries[count].arity = arity;
+	registry.entries[count].function = function;
+	registry.count.store(count + 1, std::memory_order_release);
+	compilationGeneration().fetch_add(1, std::memory_order_release);
+	return true;
+}
+
+/*	Function:	Find a built-in or registered function by name
+	Parameters:	1) string_view name	- Name of the function
+	Returns:	unsigned int - Built-in index, builtinFunctionCount + registry index, or noFunction
+*/
+unsigned int findFunction(std::string_view name)
+{
+	const unsigned int builtin = findBuiltinFunction(name);
+
+	if (builtin != noFunction)
+	{
+		return builtin;
+	}
+
+	const unsigned int registered = findRegisteredFunction(name);
+	return registered == noFunction ? noFunction : builtinFunctionCount + registered;
+}
+
+/*	Functions:	Fewest & most arguments a function found by findFunction accepts
+	Parameters:	1) unsigned int function	- Function to look up
+	Returns:	unsigned int
+*/
+unsigned int functionMinimumArguments(unsigned int function)
+{
+	return function < builtinFunctionCount ? builtinFunctions[function].minimumArguments
+		: functionRegistry().entries[function - builtinFunctionCount].arity;
+}
+
+unsigned int functionMaximumArguments(unsigned int function)
+{
+	return function < builtinFunctionCount ? builtinFunctions[function].maximumArguments
+		: functionRegistry().entries[function - builtinFunctionCount].arity;
+}
+
+/*	Function:	Call a registered function on the arguments at the top of a value stack
+	Parameters:	1) int operand			- Operand of the Call instruction
+				2) int ptr arguments	- First of callArity(operand) arguments; receives the result
+	Returns:	EvaluationError - None on success, otherwise the function's error
+*/
+inline EvaluationError invokeFunction(int operand, int* arguments)
+{
+	int value = 0;
+	const EvaluationError error = functionRegistry().entries[callFunction(operand)].function(arguments, value);
+	arguments[0] = value;
+	return error;
+}
+#pragma endregion
+
+#pragma region Numeric Types
+/*	Struct:		- Integer whose arithmetic reports overflow instead of wrapping
+				- Evaluating with Checked<int64_t> fails with EvaluationError::Overflow
+					as soon as any intermediate result does not fit
+*/
+template <typename Integer>
+struct Checked
+{
+	Integer value = 0;
+};
+
+/*	Function:	Convert the digits of a number token to an integer of any width
+	Parameters:	1) string_view digits	- Characters of the number token
+				2) Integer ref value	- Reference to the variable for storing the value
+	Returns:	bool - Whether or not the number is a whole number that fits in an Integer
+*/
+template <typename Integer>
+bool parseWholeNumber(std::string_view digits, Integer& value)
+{
+	Integer accumulated = 0;
+
+	for (size_t i = 0; i < digits.size(); i++)
+	{
+		if (!isDigitCharacter(digits[i])
+			|| __builtin_mul_overflow(accumulated, 10, &accumulated)
+			|| __builtin_add_overflow(accumulated, digits[i] - '0', &accumulated))
+		{
+			return false;
+		}
+	}
+
+	value = accumulated;
+	return true;
+}
+
+/*	Struct:		- Parsing & arithmetic for each value type the evaluator can be instantiated with
+				- Every member is a static inline function, so an instantiation of the
+					typed interpreter compiles to straight-line arithmetic with no dispatch
+				- Specialisations provide:
+					parse(text, value)					- Number token to value; false if not representable
+					apply(opCode, lhs, rhs, value)		- Binary operator; EvaluationError on failure
+					negate(value)						- Unary minus in place; EvaluationError on failure
+					less(lhs, rhs)						- Ordering, for min, max & abs
+*/
+template <typename Value>
+struct ValueTraits;
+
+// int - the engine's native type; shares applyOperator with the untyped interpreters
+template <>
+struct ValueTraits<int>
+{
+	static bool parse(std::string_view text, int& value) { return parseInteger(text, value); }
+	static EvaluationError apply(OpCode opCode, int lhs, int rhs, int& value) { return applyOperator(opCode, lhs, rhs, value); }
+	static EvaluationError negate(int& value) { value = wrappingNegate(value); return EvaluationError::None; }
+	static bool less(int lhs, int rhs) { return lhs < rhs; }
+};
+
+// int64_t - wraps like int, over a 64-bit range
+template <>
+struct ValueTraits<int64_t>
+{
+	static bool parse(std::string_view text, int64_t& value) { return parseWholeNumber(text, value); }
+
+	static EvaluationError apply(OpCode opCode, int64_t lhs, int64_t rhs, int64_t& value)
+	{
+		switch (opCode)
+		{
+			case OpCode::Add:		value = wrappingAdd(lhs, rhs); return EvaluationError::None;
+			case OpCode::Subtract:	value = wrappingSubtract(lhs, rhs); return EvaluationError::None;
+			case OpCode::Multiply:	value = wrappingMultiply(lhs, rhs); return EvaluationError::None;
+			case OpCode::Divide:	return divideIntegers(lhs, rhs, value);
+
+			default:
+				return EvaluationError::InvalidToken;
+		}
+	}
+
+	static EvaluationError negate(int64_t& value) { value = wrappingNegate(value); return EvaluationError::None; }
+	static bool less(int64_t lhs, int64_t rhs) { return lhs < rhs; }
+};
+
+// double - accepts decimal constants such as 2.5; division by zero is still an error
+template <>
+struct ValueTraits<double>
+{
+	static bool parse(std::string_view text, double& value)
+	{
+		// At most one decimal point, with digits on both sides
+		const size_t point = text.find('.');
+
+		if (point != std::string_view::npos
+			&& (point + 1 == text.size() || text.find('.', point + 1) != std::string_view::npos))
+		{
+			return false;
+		}
+
+		// from_chars reads the view in place & ignores the C locale; a value beyond double's range is not representable
+		const std::from_chars_result parsed = std::from_chars(text.data(), text.data() + text.size(), value, std::chars_format::fixed);
+		return parsed.ec == std::errc() && parsed.ptr == text.data() + text.size();
+	}
+
+	static EvaluationError apply(OpCode opCode, double lhs, double rhs, double& value)
+	{
+		switch (opCode)
+		{
+			case OpCode::Add:		value = lhs + rhs; return EvaluationError::None;
+			case OpCode::Subtract:	value = lhs - rhs; return EvaluationError::None;
+			case OpCode::Multiply:	value = lhs * rhs; return EvaluationError::None;
+
+			case OpCode::Divide:
+				if (rhs == 0.0)
+				{
+					return EvaluationError::DivisionByZero;
+				}
+
+				value = lhs / rhs;
+				return EvaluationError::None;
+
+			default:
+				return EvaluationError::InvalidToken;
+		}
+	}
+
+	static EvaluationError negate(double& value) { value = -value; return EvaluationError::None; }
+	static bool less(double lhs, double rhs) { return lhs < rhs; }
+};
+
+// Checked<Integer> - every operation is checked with the compiler's overflow builtins
+template <typename Integer>
+struct ValueTraits<Checked<Integer>>
+{
+	static bool parse(std::string_view text, Checked<Integer>& value) { return parseWholeNumber(text, value.value); }
+
+	static EvaluationError apply(OpCode opCode, Checked<Integer> lhs, Checked<Integer> rhs, Checked<Integer>& value)
+	{
+		bool overflowed = false;
+
+		switch (opCode)
+		{
+			case OpCode::Add:		overflowed = __builtin_add_overflow(lhs.value, rhs.value, &value.value); break;
+			case OpCode::Subtract:	overflowed = __builtin_sub_overflow(lhs.value, rhs.value, &value.value); break;
+			case OpCode::Multiply:	overflowed = __builtin_mul_overflow(lhs.value, rhs.value, &value.value); break;
+
+			case OpCode::Divide:
+				if (rhs.value == 0)
+				{
+					return EvaluationError::DivisionByZero;
+				}
+
+				// The one quotient that does not fit
+				if (rhs.value == -1 && lhs.value == std::numeric_limits<Integer>::min())
+				{
+					return EvaluationError::Overflow;
+				}
+
+				value.value = lhs.value / rhs.value;
+				break;
+
+			default:
+				return EvaluationError::InvalidToken;
+		}
+
+		return overflowed ? EvaluationError::Overflow : EvaluationError::None;
+	}
+
+	static EvaluationError negate(Checked<Integer>& value)
+	{
+		return __builtin_sub_overflow(Integer(0), value.value, &value.value) ? EvaluationError::Overflow : EvaluationError::None;
+	}
+
+	static bool less(Checked<Integer> lhs, Checked<Integer> rhs) { return lhs.value < rhs.value; }
+};
+
+/*	Class:		- Arbitrary-precision integer that stores values fitting in int64_t inline
+				- Promotes to a heap-backed sign & magnitude only when a result overflows,
+					and demotes back as soon as a result fits again, so an expression whose
+					values stay small never allocates & runs on the int64_t fast path
+				- Inline arithmetic lives in ValueTraits<BigInteger>; everything touching
+					the magnitude is kept out of line & marked cold
+*/
+class BigInteger
+{
+	public:
+		BigInteger() = default;
+		BigInteger(int64_t value) : small(value) {}
+		BigInteger(const BigInteger& other) : small(other.small) { if (other.large) { copyLarge(other); } }
+		BigInteger(BigInteger&& other) noexcept : small(other.small), large(std::move(other.large)) {}
+
+		BigInteger& operator=(const BigInteger& other)
+		{
+			if (!large && !other.large)
+			{
+				small = other.small;
+			}
+
+			else if (this != &other)
+			{
+				assignSlow(other);
+			}
+
+			return *this;
+		}
+
+		BigInteger& operator=(BigInteger&& other) noexcept
+		{
+			small = other.small;
+			large = std::move(other.large);
+			return *this;
+		}
+
+		BigInteger& operator=(int64_t value)
+		{
+			if (large)
+			{
+				large.reset();
+			}
+
+			small = value;
+			return *this;
+		}
+
+		// Whether the value is held inline, i.e. fits in an int64_t
+		bool isSmall() const { return !large; }
+
+		// Inline value; only meaningful when isSmall()
+		int64_t smallValue() const { return small; }
+
+		// Decimal representation, with a leading '-' for negative values
+		std::string toString() const;
+
+		// Values are normalised, so an inline value never equals a heap-backed one
+		friend bool operator==(const BigInteger& lhs, const BigInteger& rhs)
+		{
+			if (!lhs.large && !rhs.large)
+			{
+				return lhs.small == rhs.small;
+			}
+
+			return lhs.large && rhs.large && lhs.large->negative == rhs.large->negative && lhs.large->limbs == rhs.large->limbs;
+		}
+
+		friend bool operator!=(const BigInteger& lhs, const BigInteger& rhs) { return !(lhs == rhs); }
+
+	private:
+		friend struct ValueTraits<BigInteger>;
+
+		// Sign & magnitude; limbs are base 2^32, least significant first, with no leading zeros
+		struct Magnitude
+		{
+			bool negative = false;
+			std::vector<uint32_t> limbs;
+		};
+
+		int64_t small = 0;					// Value while there is no magnitude
+		std::unique_ptr<Magnitude> large;	// Set only for values outside the int64_t range
+
+		void copyLarge(const BigInteger& other);
+		void assignSlow(const BigInteger& other);
+
+		// Slow paths, entered only once a value leaves the int64_t range
+		static void toMagnitude(const BigInteger& value, Magnitude& magnitude);
+		static void fromMagnitude(Magnitude&& magnitude, BigInteger& value);
+		static bool parseLarge(std::string_view digits, BigInteger& value);
+		static EvaluationError applyLarge(OpCode opCode, const BigInteger& lhs, const BigInteger& rhs, BigInteger& value);
+		static void negateLarge(BigInteger& value);
+		static bool lessLarge(const BigInteger& lhs, const BigInteger& rhs);
+};
+
+// Magnitude helpers for BigInteger; every vector holds base 2^32 limbs, least significant first
+namespace bigint
+{
+	// Drop leading zero limbs so every magnitude has one representation
+	inline void trim(std::vector<uint32_t>& limbs)
+	{
+		while (!limbs.empty() && limbs.back() == 0)
+		{
+			limbs.pop_back();
+		}
+	}
+
+	// -1, 0 or 1 as lhs is less than, equal to or greater than rhs
+	inline int compare(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs)
+	{
+		if (lhs.size() != rhs.size())
+		{
+			return lhs.size() < rhs.size() ? -1 : 1;
+		}
+
+		for (size_t i = lhs.size(); i-- > 0;)
+		{
+			if (lhs[i] != rhs[i])
+			{
+				return lhs[i] < rhs[i] ? -1 : 1;
+			}
+		}
+
+		return 0;
+	}
+
+	inline std::vector<uint32_t> add(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs)
+	{
+		const std::vector<uint32_t>& longer = lhs.size() < rhs.size() ? rhs : lhs;
+		const std::vector<uint32_t>& shorter = lhs.size() < rhs.size() ? lhs : rhs;
+		std::vector<uint32_t> sum(longer.size() + 1);
+		uint64_t carry = 0;
+
+		for (size_t i = 0; i < longer.size(); i++)
+		{
+			carry += static_cast<uint64_t>(longer[i]) + (i < shorter.size() ? shorter[i] : 0);
+			sum[i] = static_cast<uint32_t>(carry);
+			carry >>= 32;
+		}
+
+		sum[longer.size()] = static_cast<uint32_t>(carry);
+		trim(sum);
+		return sum;
+	}
+
+	// lhs - rhs; requires lhs >= rhs
+	inline std::vector<uint32_t> subtract(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs)
+	{
+		std::vector<uint32_t> difference(lhs.size());
+		int64_t borrow = 0;
+
+		for (size_t i = 0; i < lhs.size(); i++)
+		{
+			int64_t limb = static_cast<int64_t>(lhs[i]) - borrow - (i < rhs.size() ? rhs[i] : 0);
+			borrow = limb < 0;
+			difference[i] = static_cast<uint32_t>(limb + (borrow << 32));
+		}
+
+		trim(difference);
+		return difference;
+	}
+
+	inline std::vector<uint32_t> multiply(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs)
+	{
+		if (lhs.empty() || rhs.empty())
+		{
+			return {};
+		}
+
+		std::vector<uint32_t> product(lhs.size() + rhs.size());
+
+		for (size_t i = 0; i < lhs.size(); i++)
+		{
+			uint64_t carry = 0;
+
+			for (size_t j = 0; j < rhs.size(); j++)
+			{
+				carry += static_cast<uint64_t>(lhs[i]) * rhs[j] + product[i + j];
+				product[i + j] = static_cast<uint32_t>(carry);
+				carry >>= 32;
+			}
+
+			product[i + rhs.size()] = static_cast<uint32_t>(carry);
+		}
+
+		trim(product);
+		return product;
+	}
+
+	// Divides limbs in place by a single limb, returning the remainder
+	inline uint32_t divideSmall(std::vector<uint32_t>& limbs, uint32_t divisor)
+	{
+		uint64_t remainder = 0;
+
+		for (size_t i = limbs.size(); i-- > 0;)
+		{
+			remainder = (remainder << 32) | limbs[i];
+			limbs[i] = static_cast<uint32_t>(remainder / divisor);
+			remainder %= divisor;
+		}
+
+		trim(limbs);
+		return static_cast<uint32_t>(remainder);
+	}
+
+	// Truncating quotient of lhs / rhs; requires rhs to be non-zero
+	//		- Shift-subtract long division for multi-limb divisors; the operands of
+	//			an expression are a handful of limbs, so this is not worth Knuth's algorithm D
+	inline std::vector<uint32_t> divide(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs)
+	{
+		if (rhs.size() == 1)
+		{
+			std::vector<uint32_t> quotient = lhs;
+			divideSmall(quotient, rhs[0]);
+			return quotient;
+		}
+
+		std::vector<uint32_t> quotient(lhs.size());
+		std::vector<uint32_t> remainder;
+
+		for (size_t bit = lhs.size() * 32; bit-- > 0;)
+		{
+			// remainder = remainder * 2 + next bit of lhs
+			uint32_t carry = (lhs[bit / 32] >> (bit % 32)) & 1;
+
+			for (size_t i = 0; i < remainder.size(); i++)
+			{
+				const uint32_t next = remainder[i] >> 31;
+				remainder[i] = (remainder[i] << 1) | carry;
+				carry = next;
+			}
+
+			if (carry)
+			{
+				remainder.push_back(carry);
+			}
+
+			if (compare(remainder, rhs) >= 0)
+			{
+				remainder = subtract(remainder, rhs);
+				quotient[bit / 32] |= uint32_t(1) << (bit % 32);
+			}
+		}
+
+		trim(quotient);
+		return quotient;
+	}
+}
+
+void BigInteger::copyLarge(const BigInteger& other)
+{
+	large.reset(new Magnitude(*other.large));
+}
+
+void BigInteger::assignSlow(const BigInteger& other)
+{
+	small = other.small;
+
+	if (!other.large)
+	{
+		large.reset();
+	}
+
+	else if (large)
+	{
+		*large = *other.large;
+	}
+
+	else
+	{
+		copyLarge(other);
+	}
+}
+
+/*	Function:	Widen any value, inline or not, to a sign & magnitude
+	Parameters:	1) BigInteger ref value			- Value to widen
+				2) Magnitude ref magnitude		- Receives the sign & limbs
+*/
+void BigInteger::toMagnitude(const BigInteger& value, Magnitude& magnitude)
+{
+	if (value.large)
+	{
+		magnitude = *value.large;
+		return;
+	}
+
+	// Negate as unsigned so INT64_MIN has a magnitude
+	magnitude.negative = value.small < 0;
+	const uint64_t absolute = magnitude.negative ? 0 - static_cast<uint64_t>(value.small) : static_cast<uint64_t>(value.small);
+	magnitude.limbs.assign({ static_cast<uint32_t>(absolute), static_cast<uint32_t>(absolute >> 32) });
+	bigint::trim(magnitude.limbs);
+}
+
+/*	Function:	Store a sign & magnitude, demoting to an inline value whenever it fits
+	Parameters:	1) Magnitude rvalue magnitude	- Trimmed sign & limbs of the result
+				2) BigInteger ref value			- Receives the normalised value
+*/
+void BigInteger::fromMagnitude(Magnitude&& magnitude, BigInteger& value)
+{
+	if (magnitude.limbs.size() <= 2)
+	{
+		const uint64_t absolute = (magnitude.limbs.size() > 0 ? magnitude.limbs[0] : 0)
+			| (magnitude.limbs.size() > 1 ? static_cast<uint64_t>(magnitude.limbs[1]) << 32 : 0);
+		const uint64_t limit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + (magnitude.negative ? 1 : 0);
+
+		if (absolute <= limit)
+		{
+			value = magnitude.negative ? static_cast<int64_t>(0 - absolute) : static_cast<int64_t>(absolute);
+			return;
+		}
+	}
+
+	if (!value.large)
+	{
+		value.large.reset(new Magnitude);
+	}
+
+	*value.large = std::move(magnitude);
+}
+
+/*	Function:	Parse a number token too long for int64_t
+	Parameters:	1) string_view digits		- Characters of the number token
+				2) BigInteger ref value		- Reference to the variable for storing the value
+	Returns:	bool - Whether or not the token was a whole number
+*/
+bool BigInteger::parseLarge(std::string_view digits, BigInteger& value)
+{
+	Magnitude magnitude;
+
+	// Consume nine digits at a time, the most that fit in one limb
+	for (size_t i = 0; i < digits.size(); i += 9)
+	{
+		const std::string_view chunk = digits.substr(i, 9);
+		uint32_t chunkValue = 0;
+		uint32_t scale = 1;
+
+		for (size_t j = 0; j < chunk.size(); j++)
+		{
+			if (!isDigitCharacter(chunk[j]))
+			{
+				return false;
+			}
+
+			chunkValue = chunkValue * 10 + static_cast<uint32_t>(chunk[j] - '0');
+			scale *= 10;
+		}
+
+		// magnitude = magnitude * scale + chunkValue
+		uint64_t carry = chunkValue;
+
+		for (size_t j = 0; j < magnitude.limbs.size(); j++)
+		{
+			carry += static_cast<uint64_t>(magnitude.limbs[j]) * scale;
+			magnitude.limbs[j] = static_cast<uint32_t>(carry);
+			carry >>= 32;
+		}
+
+		if (carry)
+		{
+			magnitude.limbs.push_back(static_cast<uint32_t>(carry));
+		}
+	}
+
+	fromMagnitude(std::move(magnitude), value);
+	return true;
+}
+
+/*	Function:	Apply a binary operator to operands of any size
+	Parameters:	1) OpCode opCode		- Operator to apply
+				2) BigInteger ref lhs	- Value beneath the top of the stack
+				3) BigInteger ref rhs	- Value on top of the stack
+				4) BigInteger ref value	- Receives the result; may alias lhs
+	Returns:	EvaluationError - None on success
+*/
+__attribute__((noinline, cold))
+EvaluationError BigInteger::applyLarge(OpCode opCode, const BigInteger& lhs, const BigInteger& rhs, BigInteger& value)
+{
+	Magnitude left;
+	Magnitude right;
+	Magnitude result;
+	toMagnitude(lhs, left);
+	toMagnitude(rhs, right);
+
+	switch (opCode)
+	{
+		case OpCode::Subtract:
+			// lhs - rhs is lhs + (-rhs)
+			right.negative = !right.negative;
+			[[fallthrough]];
+
+		case OpCode::Add:
+			if (left.negative == right.negative)
+			{
+				result.negative = left.negative;
+				result.limbs = bigint::add(left.limbs, right.limbs);
+			}
+
+			else if (bigint::compare(left.limbs, right.limbs) >= 0)
+			{
+				result.negative = left.negative;
+				result.limbs = bigint::subtract(left.limbs, right.limbs);
+			}
+
+			else
+			{
+				result.negative = right.negative;
+				result.limbs = bigint::subtract(right.limbs, left.limbs);
+			}
+
+			break;
+
+		case OpCode::Multiply:
+			result.negative = left.negative != right.negative;
+			result.limbs = bigint::multiply(left.limbs, right.limbs);
+			break;
+
+		case OpCode::Divide:
+			if (right.limbs.empty())
+			{
+				return EvaluationError::DivisionByZero;
+			}
+
+			// Truncates towards zero, as integer division does
+			result.negative = left.negative != right.negative;
+			result.limbs = bigint::divide(left.limbs, right.limbs);
+			break;
+
+		default:
+			return EvaluationError::InvalidToken;
+	}
+
+	fromMagnitude(std::move(result), value);
+	return EvaluationError::None;
+}
+
+// Negates INT64_MIN & heap-backed values, the ones whose negation may change representation
+__attribute__((noinline, cold))
+void BigInteger::negateLarge(BigInteger& value)
+{
+	Magnitude magnitude;
+	toMagnitude(value, magnitude);
+	magnitude.negative = !magnitude.negative;
+	fromMagnitude(std::move(magnitude), value);
+}
+
+// Orders values where at least one is heap-backed
+__attribute__((noinline, cold))
+bool BigInteger::lessLarge(const BigInteger& lhs, const BigInteger& rhs)
+{
+	Magnitude left;
+	Magnitude right;
+	toMagnitude(lhs, left);
+	toMagnitude(rhs, right);
+
+	if (left.negative != right.negative)
+	{
+		return left.negative;
+	}
+
+	const int comparison = bigint::compare(left.limbs, right.limbs);
+	return left.negative ? comparison > 0 : comparison < 0;
+}
+
+std::string BigInteger::toString() const
+{
+	if (!large)
+	{
+		return std::to_string(small);
+	}
+
+	// Peel off nine decimal digits at a time, least significant first
+	std::vector<uint32_t> limbs = large->limbs;
+	std::string digits;
+
+	while (!limbs.empty())
+	{
+		uint32_t chunk = bigint::divideSmall(limbs, 1000000000);
+
+		for (int i = 0; i < 9 && (chunk != 0 || !limbs.empty()); i++)
+		{
+			digits.push_back(static_cast<char>('0' + chunk % 10));
+			chunk /= 10;
+		}
+	}
+
+	if (large->negative)
+	{
+		digits.push_back('-');
+	}
+
+	std::reverse(digits.begin(), digits.end());
+	return digits;
+}
+
+// BigInteger - int64_t arithmetic inline, with overflow handing over to the out-of-line bignum path
+template <>
+struct ValueTraits<BigInteger>
+{
+	static bool parse(std::string_view text, BigInteger& value)
+	{
+		int64_t small = 0;
+
+		if (parseWholeNumber(text, small))
+		{
+			value = small;
+			return true;
+		}
+
+		return BigInteger::parseLarge(text, value);
+	}
+
+	static EvaluationError apply(OpCode opCode, const BigInteger& lhs, const BigInteger& rhs, BigInteger& value)
+	{
+		if (!lhs.large && !rhs.large)
+		{
+			const int64_t left = lhs.small;
+			const int64_t right = rhs.small;
+			int64_t result = 0;
+
+			switch (opCode)
+			{
+				case OpCode::Add:
+					if (!__builtin_add_overflow(left, right, &result)) { value = result; return EvaluationError::None; }
+					break;
+
+				case OpCode::Subtract:
+					if (!__builtin_sub_overflow(left, right, &result)) { value = result; return EvaluationError::None; }
+					break;
+
+				case OpCode::Multiply:
+					if (!__builtin_mul_overflow(left, right, &result)) { value = result; return EvaluationError::None; }
+					break;
+
+				case OpCode::Divide:
+					if (right == 0)
+					{
+						return EvaluationError::DivisionByZero;
+					}
+
+					// INT64_MIN / -1 is the one quotient that does not fit
+					if (right != -1 || left != std::numeric_limits<int64_t>::min())
+					{
+						value = left / right;
+						return EvaluationError::None;
+					}
+
+					break;
+
+				default:
+					return EvaluationError::InvalidToken;
+			}
+		}
+
+		return BigInteger::applyLarge(opCode, lhs, rhs, value);
+	}
+
+	static EvaluationError negate(BigInteger& value)
+	{
+		if (!value.large && value.small != std::numeric_limits<int64_t>::min())
+		{
+			value.small = -value.small;
+		}
+
+		else
+		{
+			BigInteger::negateLarge(value);
+		}
+
+		return EvaluationError::None;
+	}
+
+	static bool less(const BigInteger& lhs, const BigInteger& rhs)
+	{
+		return !lhs.large && !rhs.large ? lhs.small < rhs.small : BigInteger::lessLarge(lhs, rhs);
+	}
+};
+#pragma endregion
+
+#pragma region Shunting Yard Algorithm
+/*	Struct:		- Bounds on the work a single expression may cause, so untrusted input fails fast
+				- Enforced during the single tokenising & shunting pass: the length before any token
+					is read, the token count & operator stack depth as each token arrives
+				- Rejected input therefore costs time & memory proportional to the limit, not to its size
+				- Every limit defaults to unlimited
+*/
+struct EvaluationLimits
+{
+	size_t maximumLength = SIZE_MAX;	// Characters in the expression, whitespace included
+	size_t maximumTokens = SIZE_MAX;	// Tokens in the expression
+	size_t maximumDepth = SIZE_MAX;		// Operators, functions & left brackets waiting on the operator stack at once
+};
+
+/*	Struct:		Limits in force, one relaxed atomic per field so they may change while other threads evaluate
+*/
+struct EvaluationLimitSettings
+{
+	std::atomic<size_t> maximumLength{ SIZE_MAX };
+	std::atomic<size_t> maximumTokens{ SIZE_MAX };
+	std::atomic<size_t> maximumDepth{ SIZE_MAX };
+};
+
+EvaluationLimitSettings& evaluationLimitSettings()
+{
+	static EvaluationLimitSettings settings;
+	return settings;
+}
+
+/*	Function:	- Set the limits applied to every expression shunted from now on, on any thread
+				- Each shunt reads them once as it begins, so one already under way keeps its limits
+				- Bumps compilationGeneration(), so ExpressionCache entries compiled under the old
+					limits are dropped rather than answered from
+	Parameters:	1) EvaluationLimits ref limits	- Limits to apply
+	Returns:	void
+*/
+void setEvaluationLimits(const EvaluationLimits& limits)
+{
+	EvaluationLimitSettings& settings = evaluationLimitSettings();
+	settings.maximumLength.store(limits.maximumLength, std::memory_order_relaxed);
+	settings.maximumTokens.store(limits.maximumTokens, std::memory_order_relaxed);
+	settings.maximumDepth.store(limits.maximumDepth, std::memory_order_relaxed);
+	compilationGeneration().fetch_add(1, std::memory_order_release);
+}
+
+/*	Function:	Limits currently in force
+	Returns:	EvaluationLimits
+*/
+EvaluationLimits evaluationLimits()
+{
+	const EvaluationLimitSettings& settings = evaluationLimitSettings();
+	EvaluationLimits limits;
+	limits.maximumLength = settings.maximumLength.load(std::memory_order_relaxed);
+	limits.maximumTokens = settings.maximumTokens.load(std::memory_order_relaxed);
+	limits.maximumDepth = settings.maximumDepth.load(std::memory_order_relaxed);
+	return limits;
+}
+
+class ShuntingYard
+{
+	// Public declarations
+	public:
+		bool shuntInfixToRPN(const std::vector<std::string>& inputTokens, std::vector<std::string>& returnArray);
+		EvaluationStatus shuntInfixToRPN(std::string_view expression, std::vector<Instruction>& program);
+
+		// Incremental interface used by shuntInfixToRPN & the streaming evaluator
+		// Tokens are fed one at a time; each instruction is passed to sink.emit()
+		//		as soon as the algorithm outputs it
+		void beginShunt();
+
+		template <typename Sink>
+		EvaluationStatus shuntToken(const Token& token, std::string_view text, Sink& sink);
+
+		template <typename Sink>
+		EvaluationStatus endShunt(Sink& sink);
+
+		// Pre-size the operator stack for expressions of up to the given length
+		void reserve(size_t expressionLength);
+
+		// Names of the variables referenced by the last bytecode shunt, indexed by PushVariable operands
+		// Views into the shunted expression; only valid while it is alive
+		const std::vector<std::string_view>& variables() const { return variableNames; }
+
+		// Character offset of the token behind each instruction emitted by the last bytecode shunt
+		// Used to report evaluation errors against the original expression
+		const std::vector<unsigned int>& offsets() const { return instructionOffsets; }
+
+		// When set, numbers are not parsed as int but emitted as PushLiteral, leaving
+		//		their text in literals() for a typed compile to parse
+		void setLiteralConstants(bool enabled) { literalConstants = enabled; }
+
+		// Text of each number shunted in literal mode, indexed by PushLiteral operands
+		// Views into the shunted expression; only valid while it is alive
+		const std::vector<std::string_view>& literals() const { return literalTexts; }
+
+		// Limits in force for the current bytecode shunt, read when it began
+		const EvaluationLimits& limitsInForce() const { return limits; }
+
+		// Tokens read & deepest operator stack of the last bytecode shunt
+		// Tokens are always counted, for EvaluationLimits; the peak only when SHUNTING_YARD_STATS is defined
+		size_t tokensShunted() const { return tokenCount; }
+		size_t operatorStackPeak() const { return operatorPeak; }
+
+		// Bytes of scratch buffer held, to detect allocations
+		size_t capacity() const
+		{
+			return pendingOperators.capacity() * sizeof(PendingOperator) + variableNames.capacity() * sizeof(std::string_view)
+				+ literalTexts.capacity() * sizeof(std::string_view) + instructionOffsets.capacity() * sizeof(unsigned int);
+		}
+
+	private:
+		// Declare operator stack
+		// Stores arithmetic operators
+		std::stack<std::string> operatorStack;
+
+		// Declare output queue
+		// Stores RPN output
+		std::queue<std::string> outputQueue;
+
+		// Operator, function or left bracket waiting on the bytecode shunt's operator stack
+		struct PendingOperator
+		{
+			TokenKind kind;					// Operator, Function or LeftParenthesis
+			unsigned char operatorIndex;	// Row of operatorTable; unused otherwise
+			unsigned char arguments = 0;	// Arguments of the call completed so far
+			unsigned int offset;			// Offset of the token, for error reporting
+			unsigned short function = 0;	// Function called, as findFunction returns
+		};
+
+		// Push onto the operator stack, unless that would pass the depth limit
+		EvaluationStatus pushPending(const PendingOperator& pending);
+
+		template <typename Sink>
+		EvaluationStatus completeArgument(PendingOperator& call, Sink& sink);
+
+		template <typename Sink>
+		EvaluationStatus finishCall(const PendingOperator& call, Sink& sink);
+
+		// Operators & left brackets waiting to be output by the bytecode shunt
+		// Kept as a member so its capacity is reused between calls
+		std::vector<PendingOperator> pendingOperators;
+
+		// Distinct variable names in order of first appearance
+		std::vector<std::string_view> variableNames;
+
+		// Numbers left unparsed in literal mode
+		std::vector<std::string_view> literalTexts;
+		bool literalConstants = false;
+
+		// Instrumentation of the last bytecode shunt
+		size_t tokenCount = 0;
+		size_t operatorPeak = 0;
+
+		// Limits in force when the current shunt began
+		EvaluationLimits limits;
+
+		// Whether the next token should start an operand, i.e. the previous token was an
+		//		operator or left bracket; decides whether '-' is negation or subtraction
+		bool expectingOperand = true;
+
+		// Kind of the previous token & offset of the last variable, to tell unknown functions from variables
+		TokenKind previousKind = TokenKind::Invalid;
+		unsigned int previousOffset = 0;
+
+		// Source offset of each emitted instruction
+		std::vector<unsigned int> instructionOffsets;
+
+		// Sink appending emitted instructions to a program
+		struct ProgramSink
+		{
+			std::vector<Instruction>& program;
+			std::vector<unsigned int>& offsets;
+
+			EvaluationStatus emit(const Instruction& instruction, unsigned int offset)
+			{
+				program.push_back(instruction);
+				offsets.push_back(offset);
+				return EvaluationStatus();
+			}
+		};
+};
+
+/*	Function:	Pre-size the bytecode shunt's buffers for expressions of up to the given length
+	Parameters:	1) size_t expressionLength	- Length of the longest expression to be shunted
+	Returns:	void
+*/
+void ShuntingYard::reserve(size_t expressionLength)
+{
+	pendingOperators.reserve(expressionLength);
+	variableNames.reserve(expressionLength);
+	instructionOffsets.reserve(expressionLength);
+}
+
+/*	Function:	- Implementation of the Shunting-Yard algorithm
+				- Convert infix notation to postfix (RPN)
+	Parameters: 1) Vector<string> ref inputTokens	- Reference to the tokens to convert
+				2) Vector<string ref returnArray	- Reference to the collection of postfix tokens
+													- Pass-by-reference used to directly modify the
+														stored collection without having to return a value & 
+														allow the method to return true/false for a successful conversion
+	Returns: 1) bool	- Whether or not the conversion was successful
+*/
+bool ShuntingYard::shuntInfixToRPN(const std::vector<std::string>& inputTokens, std::vector<std::string>& returnArray)
+{
+	// Discard anything left behind by an earlier failed conversion
+	operatorStack = std::stack<std::string>();
+	outputQueue = std::queue<std::string>();
+
+	const EvaluationLimits limits = evaluationLimits();
+
+	// Iterate through tokens
+	for (unsigned int i = 0; i < inputTokens.size(); i++)
+	{
+		const std::string currentToken = inputTokens[i];				// Cache the current token to check
+
+		// Stop at the first token past the limit; the trailing empty token does not count
+		if (i >= limits.maximumTokens && !currentToken.empty())
+		{
+			SY_LOG("Failure Point: Too many tokens \n");
+			return false;
+		}
+
+		// Operators & left brackets both wait on the operator stack
+		if ((isOperator(currentToken) || currentToken == "(") && operatorStack.size() >= limits.maximumDepth)
+		{
+			SY_LOG("Failure Point: Nesting too deep \n");
+			return false;
+		}
+		
+		// Check if token is a number
+		if (verifyInteger(currentToken))
+		{
+			// Push number to output queue
+			outputQueue.push(currentToken);
+		}
+
+		// Check if token is an operator
+		else if (isOperator(currentToken))
+		{
+			// Push to operator stack
+			operatorStack.push(currentToken);
+		}
+
+		// Check if token is left bracket
+		else if (currentToken == "(")
+		{
+			// Push to operator stack
+			operatorStack.push(currentToken);
+		}
+
+		// Check if token is right bracket
+		else if (currentToken == ")")
+		{
+			// Cache the initial top token of the operator stack
+			std::string topOperatorStackToken = operatorStack.top();
+
+			// Until the token at the top of the stack is a left parenthesis, 
+			//		pop operators off the stack onto the output queue
+			// When the loop exits either the stack will be empty,
+			//		or the left parenthesis will be found
+			// When left parenthesis is found it can be popped off the stack,
+			//		assuming the stack is not empty
+			while (topOperatorStackToken != "(")
+			{
+				outputQueue.push(topOperatorStackToken);
+				operatorStack.pop();
+
+				// If the stack is emptied break the loop
+				if (operatorStack.empty())
+					break;
+
+				// Get new top token from operator stack
+				// Cache it for future reference
+				topOperatorStackToken = operatorStack.top();
+			} // End while() loop; Checking for left bracket
+
+			// Pop & discard the left bracket from the stack
+			if (!operatorStack.empty())
+				operatorStack.pop();
+
+			// If the stack is empty & we never found the left bracket
+			// There was a syntax error; missing bracket
+			if (topOperatorStackToken != "(")
+			{
+				SY_LOG("Failure Point: Mismatched parenthesis \n");
+				return false;
+			}	
+		}
+
+		// Otherwise, an invalid non-operator, non-integer token is present,
+		//		that is also not the null terminator
+		else if (currentToken != "\0")
+		{
+			SY_LOG("Failure Point: Default condition \n");
+			SY_LOG(currentToken.c_str());
+			return false;
+			
+		}
+	} // End for() loop; token iteration
+
+	  // While there are still tokens in the operator stack
+	  //		clear the operator stack and finalise the output queue
+	while (!operatorStack.empty())
+	{
+		const std::string topOperatorStackToken = operatorStack.top();
+
+		// If the operator on the top of the stack is a parenthesis,
+		//		then there are mismatched parenthesis
+		if (isParenthesis(topOperatorStackToken))
+		{
+			SY_LOG("Failure Point: mismatched parenthesis");
+			return false;
+		}
+			
+		// Pop the operator onto the output queue
+		outputQueue.push(topOperatorStackToken);
+		operatorStack.pop();
+	} // End while() loop; clear operator stack
+
+	// Copy output queue contents to the return array
+	while (!outputQueue.empty())
+	{
+		// Add front element of output queue to
+		//		the back of the return array
+		returnArray.push_back(outputQueue.front());
+
+		// Pop front off of output queue
+		outputQueue.pop();
+	} // End while() loop; copying  output queue
+
+	return true;
+}
+
+/*	Function:	- Implementation of the Shunting-Yard algorithm emitting bytecode
+				- Tokenises the expression with the zero-copy Lexer & converts it
+					straight to a compiled postfix (RPN) program
+	Parameters: 1) string_view expression			- Expression to convert; whitespace between tokens is optional
+				2) Vector<Instruction> ref program		- Reference to the program receiving the instructions
+	Returns: 1) EvaluationStatus	- Whether or not the conversion was successful, & if not
+										why & at which token
+*/
+EvaluationStatus ShuntingYard::shuntInfixToRPN(std::string_view expression, std::vector<Instruction>& program)
+{
+	Lexer lexer(expression);
+	Token currentToken;
+	ProgramSink sink = { program, instructionOffsets };
+	const size_t firstInstruction = program.size();
+
+	// Reject over-long input before tokenising any of it or reserving space for it
+	beginShunt();
+
+	if (expression.size() > limits.maximumLength)
+	{
+		SY_LOG("Failure Point: Expression too long \n");
+		return { EvaluationError::ExpressionTooLong, static_cast<unsigned int>(std::min<size_t>(limits.maximumLength, UINT_MAX)) };
+	}
+
+	// A token is at least one character, so the expression length bounds
+	//		both the operator stack & the program size, as does the token limit
+	// Once warm, reserving does not allocate
+	const size_t reservedTokens = std::min(expression.size(), limits.maximumTokens);
+	reserve(reservedTokens);
+	program.reserve(program.size() + reservedTokens);
+
+	// Iterate through tokens
+	while (lexer.next(currentToken))
+	{
+		const EvaluationStatus status = shuntToken(currentToken, lexer.text(currentToken), sink);
+		SY_STATS(operatorPeak = std::max(operatorPeak, pendingOperators.size()));
+
+		if (!status)
+		{
+			return status;
+		}
+	} // End while() loop; token iteration
+
+	EvaluationStatus status = endShunt(sink);
+
+	if (!status)
+	{
+		return status;
+	}
+
+	// Nothing but whitespace
+	if (program.size() == firstInstruction)
+	{
+		status.error = EvaluationError::EmptyExpression;
+		return status;
+	}
+
+	// Reject programs whose stack would underflow or be left with extra values,
+	//		so they can be run without bounds checks
+	status = verifyProgram(program.data() + firstInstruction, program.size() - firstInstruction);
+
+	if (!status)
+	{
+		SY_LOG("Failure Point: Malformed expression \n");
+		status.offset = instructionOffsets[status.offset];
+	}
+
+	return status;
+}
+
+/*	Function:	Reset the incremental shunt ready for a new expression
+	Returns:	void
+*/
+void ShuntingYard::beginShunt()
+{
+	expectingOperand = true;
+	previousKind = TokenKind::Invalid;
+	previousOffset = 0;
+	pendingOperators.clear();
+	variableNames.clear();
+	literalTexts.clear();
+	instructionOffsets.clear();
+	tokenCount = 0;
+	operatorPeak = 0;
+	limits = evaluationLimits();
+}
+
+/*	Function:	Push an entry onto the bytecode shunt's operator stack, unless the stack
+					already holds as many entries as EvaluationLimits allow
+	Parameters:	1) PendingOperator ref pending	- Operator, function or left bracket to push
+	Returns:	EvaluationStatus - NestingTooDeep, at the entry's token, if the limit was reached
+*/
+EvaluationStatus ShuntingYard::pushPending(const PendingOperator& pending)
+{
+	EvaluationStatus status;
+
+	if (pendingOperators.size() >= limits.maximumDepth)
+	{
+		SY_LOG("Failure Point: Nesting too deep \n");
+		status.error = EvaluationError::NestingTooDeep;
+		status.offset = pending.offset;
+		return status;
+	}
+
+	pendingOperators.push_back(pending);
+	return status;
+}
+
+/*	Function:	- Shunt a single token, emitting any instructions it releases
+	Parameters:	1) Token ref token		- Token to shunt
+				2) string_view text		- Characters of the token; for variables, must stay
+											alive until the shunt ends
+				3) Sink ref sink		- Receives each instruction via emit(instruction, offset)
+										- An error from the sink stops the shunt
+	Returns:	EvaluationStatus - Whether or not the token was shunted successfully
+*/
+template <typename Sink>
+EvaluationStatus ShuntingYard::shuntToken(const Token& token, std::string_view text, Sink& sink)
+{
+	EvaluationStatus status;
+	const TokenKind lastKind = previousKind;
+	previousKind = token.kind;
+
+	// Stop at the first token past the limit, however much input remains
+	if (++tokenCount > limits.maximumTokens)
+	{
+		SY_LOG("Failure Point: Too many tokens \n");
+		status.error = EvaluationError::TooManyTokens;
+		status.offset = token.offset;
+		return status;
+	}
+
+	// A function name must be followed by its argument list
+	if (lastKind == TokenKind::Function && token.kind != TokenKind::LeftParenthesis)
+	{
+		SY_LOG("Failure Point: Function without arguments \n");
+		status.error = EvaluationError::ArgumentCount;
+		status.offset = pendingOperators.back().offset;
+		return status;
+	}
+
+	switch (token.kind)
+	{
+		// Numbers go straight to the output
+		case TokenKind::Number:
+		{
+			Instruction instruction;
+			instruction.opCode = OpCode::PushConstant;
+
+			expectingOperand = false;
+
+			// Typed compiles parse constants for their own value type
+			if (literalConstants)
+			{
+				literalTexts.push_back(text);
+				return sink.emit({ OpCode::PushLiteral, static_cast<int>(literalTexts.size() - 1) }, token.offset);
+			}
+
+			if (!parseInteger(text, instruction.operand))
+			{
+				SY_LOG("Failure Point: Invalid constant \n");
+				status.error = EvaluationError::InvalidConstant;
+				status.offset = token.offset;
+				return status;
+			}
+
+			return sink.emit(instruction, token.offset);
+		}
+
+		// Variables go straight to the output, referring to their slot by index
+		// Repeated names share a single slot
+		case TokenKind::Variable:
+		{
+			// Function names wait on the operator stack for their argument list
+			const unsigned int function = findFunction(text);
+
+			if (function != noFunction)
+			{
+				previousKind = TokenKind::Function;
+				return pushPending({ TokenKind::Function, noOperator, 0, token.offset, static_cast<unsigned short>(function) });
+			}
+
+			size_t slot = 0;
+			expectingOperand = false;
+			previousOffset = token.offset;
+
+			while (slot < variableNames.size() && variableNames[slot] != text)
+			{
+				slot++;
+			}
+
+			if (slot == variableNames.size())
+			{
+				variableNames.push_back(text);
+			}
+
+			return sink.emit({ OpCode::PushVariable, static_cast<int>(slot) }, token.offset);
+		}
+
+		// Operators wait on the operator stack, after releasing any pending operators
+		//		that bind at least as tightly
+		case TokenKind::Operator:
+		{
+			// In operand position an operator can only be a prefix operator
+			const unsigned char index = expectingOperand ? unaryOperatorIndex(text[0]) : binaryOperatorIndex(text[0]);
+
+			if (index == noOperator)
+			{
+				SY_LOG("Failure Point: Operator without operand \n");
+				status.error = EvaluationError::NotEnoughArguments;
+				status.offset = token.offset;
+				return status;
+			}
+
+			const OperatorInfo& incoming = operatorTable[index];
+
+			// Prefix operators apply to what follows, so nothing before them is released
+			while (incoming.arity == 2 && !pendingOperators.empty() &&
+				pendingOperators.back().kind == TokenKind::Operator)
+			{
+				const PendingOperator pending = pendingOperators.back();
+				const OperatorInfo& top = operatorTable[pending.operatorIndex];
+
+				if (top.precedence < incoming.precedence ||
+					(top.precedence == incoming.precedence && incoming.associativity == Associativity::Right))
+				{
+					break;
+				}
+
+				pendingOperators.pop_back();
+				status = sink.emit({ top.opCode, 0 }, pending.offset);
+
+				if (!status)
+				{
+					return status;
+				}
+			}
+
+			expectingOperand = true;
+			return pushPending({ token.kind, index, 0, token.offset });
+		}
+
+		// Left brackets wait on the operator stack for their match
+		case TokenKind::LeftParenthesis:
+			// A variable followed by an argument list was meant to be a function
+			if (lastKind == TokenKind::Variable)
+			{
+				SY_LOG("Failure Point: Unknown function \n");
+				status.error = EvaluationError::UnknownFunction;
+				status.offset = previousOffset;
+				return status;
+			}
+
+			expectingOperand = true;
+			return pushPending({ token.kind, noOperator, 0, token.offset });
+
+		// Pop operators to the output until the matching left bracket
+		// Separators do the same, then complete an argument of the call the bracket opened
+		case TokenKind::RightParenthesis:
+		case TokenKind::Separator:
+		{
+			while (!pendingOperators.empty() && pendingOperators.back().kind != TokenKind::LeftParenthesis)
+			{
+				const PendingOperator pending = pendingOperators.back();
+				pendingOperators.pop_back();
+				status = sink.emit({ operatorTable[pending.operatorIndex].opCode, 0 }, pending.offset);
+
+				if (!status)
+				{
+					return status;
+				}
+			}
+
+			const bool inCall = pendingOperators.size() >= 2
+				&& pendingOperators[pendingOperators.size() - 2].kind == TokenKind::Function;
+
+			if (token.kind == TokenKind::Separator)
+			{
+				if (!inCall)
+				{
+					SY_LOG("Failure Point: Separator outside a function call \n");
+					status.error = EvaluationError::InvalidToken;
+					status.offset = token.offset;
+					return status;
+				}
+
+				// Empty argument, e.g. max ( , 1 )
+				if (expectingOperand)
+				{
+					status.error = EvaluationError::NotEnoughArguments;
+					status.offset = token.offset;
+					return status;
+				}
+
+				status = completeArgument(pendingOperators[pendingOperators.size() - 2], sink);
+				expectingOperand = true;
+				return status;
+			}
+
+			// If the stack is empty we never found the left bracket
+			if (pendingOperators.empty())
+			{
+				SY_LOG("Failure Point: Mismatched parenthesis \n");
+				status.error = EvaluationError::MismatchedParenthesis;
+				status.offset = token.offset;
+				return status;
+			}
+
+			// Pop & discard the left bracket
+			pendingOperators.pop_back();
+
+			if (inCall)
+			{
+				PendingOperator call = pendingOperators.back();
+				pendingOperators.pop_back();
+
+				// Only an empty argument list may end straight after an operator or separator
+				if (expectingOperand && lastKind != TokenKind::LeftParenthesis)
+				{
+					status.error = EvaluationError::NotEnoughArguments;
+					status.offset = token.offset;
+					return status;
+				}
+
+				if (!expectingOperand)
+				{
+					status = completeArgument(call, sink);
+				}
+
+				if (status)
+				{
+					status = finishCall(call, sink);
+				}
+			}
+
+			expectingOperand = false;
+			return status;
+		}
+
+		default:
+			SY_LOG("Failure Point: Default condition \n");
+			status.error = EvaluationError::InvalidToken;
+			status.offset = token.offset;
+			return status;
+	}
+}
+
+/*	Function:	- Complete one argument of a function call
+				- Emits the built-in function's instruction for that argument, if any
+	Parameters:	1) PendingOperator ref call	- Function entry of the operator stack
+				2) Sink ref sink			- Receives each instruction via emit(instruction, offset)
+	Returns:	EvaluationStatus - ArgumentCount if the function takes no more arguments
+*/
+template <typename Sink>
+EvaluationStatus ShuntingYard::completeArgument(PendingOperator& call, Sink& sink)
+{
+	EvaluationStatus status;
+
+	if (call.arguments == functionMaximumArguments(call.function))
+	{
+		SY_LOG("Failure Point: Too many arguments \n");
+		status.error = EvaluationError::ArgumentCount;
+		status.offset = call.offset;
+		return status;
+	}
+
+	if (call.function < builtinFunctionCount)
+	{
+		const OpCode step = argumentStep(builtinFunctions[call.function], call.arguments);
+
+		if (step != noStep)
+		{
+			status = sink.emit({ step, 0 }, call.offset);
+		}
+	}
+
+	call.arguments++;
+	return status;
+}
+
+/*	Function:	Complete a function call once its closing bracket is read
+	Parameters:	1) PendingOperator ref call	- Function entry popped off the operator stack
+				2) Sink ref sink			- Receives each instruction via emit(instruction, offset)
+	Returns:	EvaluationStatus - ArgumentCount if the call has too few arguments
+*/
+template <typename Sink>
+EvaluationStatus ShuntingYard::finishCall(const PendingOperator& call, Sink& sink)
+{
+	EvaluationStatus status;
+
+	if (call.arguments < functionMinimumArguments(call.function))
+	{
+		SY_LOG("Failure Point: Too few arguments \n");
+		status.error = EvaluationError::ArgumentCount;
+		status.offset = call.offset;
+		return status;
+	}
+
+	// Built-in functions were emitted argument by argument; registered ones are called
+	if (call.function >= builtinFunctionCount)
+	{
+		status = sink.emit({ OpCode::Call, callOperand(call.function - builtinFunctionCount, call.arguments) }, call.offset);
+	}
+
+	return status;
+}
+
+/*	Function:	Finish the incremental shunt, emitting every operator still on the stack
+	Parameters:	1) Sink ref sink	- Receives each instruction via emit(instruction, offset)
+	Returns:	EvaluationStatus - Whether or not the shunt completed successfully
+*/
+template <typename Sink>
+EvaluationStatus ShuntingYard::endShunt(Sink& sink)
+{
+	EvaluationStatus status;
+
+	// Clear the operator stack and finalise the output
+	while (!pendingOperators.empty())
+	{
+		const PendingOperator pending = pendingOperators.back();
+
+		// A bracket left on the stack was never closed
+		if (pending.kind == TokenKind::LeftParenthesis)
+		{
+			SY_LOG("Failure Point: mismatched parenthesis");
+			status.error = EvaluationError::MismatchedParenthesis;
+			status.offset = pending.offset;
+			return status;
+		}
+
+		// The expression ended straight after a function name
+		if (pending.kind == TokenKind::Function)
+		{
+			SY_LOG("Failure Point: Function without arguments");
+			status.error = EvaluationError::ArgumentCount;
+			status.offset = pending.offset;
+			return status;
+		}
+
+		pendingOperators.pop_back();
+		status = sink.emit({ operatorTable[pending.operatorIndex].opCode, 0 }, pending.offset);
+
+		if (!status)
+		{
+			return status;
+		}
+	}
+
+	return status;
+}
+#pragma endregion
+
+#pragma region Compile-Time Evaluation
+/*	Struct:		Outcome & value of an expression evaluated by ConstantEvaluator
+*/
+struct ConstantEvaluation
+{
+	EvaluationStatus status;		// Whether or not the evaluation was successful
+	int value = 0;					// Result; only meaningful on success
+
+	constexpr explicit operator bool() const { return static_cast<bool>(status); }
+};
+
+/*	Class:		- constexpr counterpart of evaluate(), for literal expressions fixed at build time
+				- Shunts with the same lexer, operator table & rules as ShuntingYard, but
+					calculates each instruction as soon as it is released rather than
+					building a program, so it needs no heap
+				- Gives the same result & error (with the same offset) as evaluate() for
+					every expression that fits in Capacity operator & value slots
+				- Bounded by Capacity rather than by EvaluationLimits
+				- Expressions have no variables at compile time; reading one is UnboundVariable
+				- Only built-in functions are known; registered functions are a run-time
+					table, so calling one is UnknownFunction
+*/
+template <size_t Capacity>
+class ConstantEvaluator
+{
+	public:
+		constexpr ConstantEvaluation evaluate(std::string_view expression);
+
+	private:
+		// An operator, function or left bracket waiting on the operator stack
+		struct PendingOperator
+		{
+			TokenKind kind = TokenKind::Invalid;
+			unsigned char operatorIndex = noOperator;
+			unsigned int offset = 0;
+			unsigned int function = 0;			// Index into builtinFunctions
+			unsigned int arguments = 0;			// Arguments of the call completed so far
+		};
+
+		constexpr EvaluationStatus shuntToken(const Token& token, std::string_view text);
+		constexpr EvaluationStatus emit(OpCode opCode, int operand, unsigned int offset);
+		constexpr EvaluationStatus completeArgument(PendingOperator& call);
+
+		PendingOperator pendingOperators[Capacity] = {};	// Operator stack
+		int values[Capacity] = {};							// Value stack
+		size_t pendingCount = 0;							// Operators on the operator stack
+		size_t depth = 0;									// Values on the value stack
+		size_t emitted = 0;									// Instructions released so far
+		bool expectingOperand = true;						// Whether an operator here would be prefix
+		TokenKind previousKind = TokenKind::Invalid;		// Previous token & offset of the last variable,
+		unsigned int previousOffset = 0;					//		to tell unknown functions from variables
+		bool halted = false;								// Calculation stopped; shunting continues
+		EvaluationStatus verification;						// First stack error, as verifyProgram finds it
+		EvaluationStatus calculation;						// Error that halted the calculation, if any
+		unsigned int secondValueOffset = 0;					// Start of the value second from the bottom
+};
+
+/*	Function:	- Verify & calculate a released instruction, as verifyProgram &
+					RPN::calculatePostfix would
+				- Errors only halt the calculation: like evaluate(), the rest of the expression
+					is still shunted so that shunting errors take priority, then stack errors,
+					then calculation errors
+				- The stack depth is tracked even once halted, so stack errors are still found
+	Parameters:	1) OpCode opCode			- Instruction released by the shunt
+				2) int operand				- Constant for PushConstant
+				3) unsigned int offset		- Source offset of the token behind the instruction
+	Returns:	EvaluationStatus - Failure only if the evaluator ran out of capacity
+*/
+template <size_t Capacity>
+constexpr EvaluationStatus ConstantEvaluator<Capacity>::emit(OpCode opCode, int operand, unsigned int offset)
+{
+	EvaluationStatus status;
+	const unsigned char arity = instructionArity({ opCode, operand });
+	emitted++;
+
+	// Stack errors stop everything; only shunting errors can still take priority
+	if (!verification)
+	{
+		return status;
+	}
+
+	if (depth < arity)
+	{
+		verification.error = EvaluationError::NotEnoughArguments;
+		verification.offset = offset;
+		return status;
+	}
+
+	if (arity == 0 && depth == Capacity)
+	{
+		status.error = EvaluationError::CapacityExceeded;
+		status.offset = offset;
+		return status;
+	}
+
+	const size_t top = depth - arity;
+	depth = top + 1;
+
+	if (arity == 0 && depth == 2)
+	{
+		secondValueOffset = offset;
+	}
+
+	if (halted)
+	{
+		return status;
+	}
+
+	switch (opCode)
+	{
+		case OpCode::PushConstant:
+			values[top] = operand;
+			return status;
+
+		case OpCode::PushVariable:
+			calculation.error = EvaluationError::UnboundVariable;
+			break;
+
+		case OpCode::Negate:
+			values[top] = negateValue(values[top], 0);
+			return status;
+
+		case OpCode::Absolute:
+			values[top] = absoluteValue(values[top], 0);
+			return status;
+
+		default:
+			calculation.error = applyOperator(opCode, values[top], values[top + 1], values[top]);
+			break;
+	}
+
+	if (!calculation)
+	{
+		halted = true;
+		calculation.offset = offset;
+	}
+
+	return status;
+}
+
+/*	Function:	Shunt a single token, as ShuntingYard::shuntToken does
+	Parameters:	1) Token ref token		- Token to shunt
+				2) string_view text		- Characters of the token
+	Returns:	EvaluationStatus - Whether or not the token was shunted successfully
+*/
+template <size_t Capacity>
+constexpr EvaluationStatus ConstantEvaluator<Capacity>::shuntToken(const Token& token, std::string_view text)
+{
+	EvaluationStatus status;
+	const TokenKind lastKind = previousKind;
+	previousKind = token.kind;
+
+	if (lastKind == TokenKind::Function && token.kind != TokenKind::LeftParenthesis)
+	{
+		status.error = EvaluationError::ArgumentCount;
+		status.offset = pendingOperators[pendingCount - 1].offset;
+		return status;
+	}
+
+	switch (token.kind)
+	{
+		case TokenKind::Number:
+		{
+			int value = 0;
+			expectingOperand = false;
+
+			if (!parseInteger(text, value))
+			{
+				status.error = EvaluationError::InvalidConstant;
+				status.offset = token.offset;
+				return status;
+			}
+
+			return emit(OpCode::PushConstant, value, token.offset);
+		}
+
+		case TokenKind::Variable:
+		{
+			const unsigned int function = findBuiltinFunction(text);
+
+			if (function != noFunction)
+			{
+				if (pendingCount == Capacity)
+				{
+					status.error = EvaluationError::CapacityExceeded;
+					status.offset = token.offset;
+					return status;
+				}
+
+				pendingOperators[pendingCount++] = { TokenKind::Function, noOperator, token.offset, function, 0 };
+				previousKind = TokenKind::Function;
+				return status;
+			}
+
+			expectingOperand = false;
+			previousOffset = token.offset;
+			return emit(OpCode::PushVariable, 0, token.offset);
+		}
+
+		case TokenKind::Operator:
+		{
+			const unsigned char index = expectingOperand ? unaryOperatorIndex(text[0]) : binaryOperatorIndex(text[0]);
+
+			if (index == noOperator)
+			{
+				status.error = EvaluationError::NotEnoughArguments;
+				status.offset = token.offset;
+				return status;
+			}
+
+			const OperatorInfo& incoming = operatorTable[index];
+
+			while (incoming.arity == 2 && pendingCount > 0 &&
+				pendingOperators[pendingCount - 1].kind == TokenKind::Operator)
+			{
+				const PendingOperator pending = pendingOperators[pendingCount - 1];
+				const OperatorInfo& top = operatorTable[pending.operatorIndex];
+
+				if (top.precedence < incoming.precedence ||
+					(top.precedence == incoming.precedence && incoming.associativity == Associativity::Right))
+				{
+					break;
+				}
+
+				pendingCount--;
+				status = emit(top.opCode, 0, pending.offset);
+
+				if (!status)
+				{
+					return status;
+				}
+			}
+
+			if (pendingCount == Capacity)
+			{
+				status.error = EvaluationError::CapacityExceeded;
+				status.offset = token.offset;
+				return status;
+			}
+
+			pendingOperators[pendingCount++] = { token.kind, index, token.offset };
+			expectingOperand = true;
+			return status;
+		}
+
+		case TokenKind::LeftParenthesis:
+			if (lastKind == TokenKind::Variable)
+			{
+				status.error = EvaluationError::UnknownFunction;
+				status.offset = previousOffset;
+				return status;
+			}
+
+			if (pendingCount == Capacity)
+			{
+				status.error = EvaluationError::CapacityExceeded;
+				status.offset = token.offset;
+				return status;
+			}
+
+			pendingOperators[pendingCount++] = { token.kind, noOperator, token.offset, 0, 0 };
+			expectingOperand = true;
+			return status;
+
+		case TokenKind::RightParenthesis:
+		case TokenKind::Separator:
+		{
+			while (pendingCount > 0 && pendingOperators[pendingCount - 1].kind != TokenKind::LeftParenthesis)
+			{
+				const PendingOperator pending = pendingOperators[--pendingCount];
+				status = emit(operatorTable[pending.operatorIndex].opCode, 0, pending.offset);
+
+				if (!status)
+				{
+					return status;
+				}
+			}
+
+			const bool inCall = pendingCount >= 2 && pendingOperators[pendingCount - 2].kind == TokenKind::Function;
+
+			if (token.kind == TokenKind::Separator)
+			{
+				if (!inCall)
+				{
+					status.error = EvaluationError::InvalidToken;
+					status.offset = token.offset;
+					return status;
+				}
+
+				if (expectingOperand)
+				{
+					status.error = EvaluationError::NotEnoughArguments;
+					status.offset = token.offset;
+					return status;
+				}
+
+				status = completeArgument(pendingOperators[pendingCount - 2]);
+				expectingOperand = true;
+				return status;
+			}
+
+			if (pendingCount == 0)
+			{
+				status.error = EvaluationError::MismatchedParenthesis;
+				status.offset = token.offset;
+				return status;
+			}
+
+			pendingCount--;
+
+			if (inCall)
+			{
+				PendingOperator call = pendingOperators[--pendingCount];
+
+				if (expectingOperand && lastKind != TokenKind::LeftParenthesis)
+				{
+					status.error = EvaluationError::NotEnoughArguments;
+					status.offset = token.offset;
+					return status;
+				}
+
+				if (!expectingOperand)
+				{
+					status = completeArgument(call);
+				}
+
+				if (status && call.arguments < builtinFunctions[call.function].minimumArguments)
+				{
+					status.error = EvaluationError::ArgumentCount;
+					status.offset = call.offset;
+				}
+			}
+
+			expectingOperand = false;
+			return status;
+		}
+
+		default:
+			status.error = EvaluationError::InvalidToken;
+			status.offset = token.offset;
+			return status;
+	}
+}
+
+/*	Function:	Complete one argument of a built-in function call, as ShuntingYard::completeArgument does
+	Parameters:	1) PendingOperator ref call	- Function entry of the operator stack
+	Returns:	EvaluationStatus - ArgumentCount if the function takes no more arguments
+*/
+template <size_t Capacity>
+constexpr EvaluationStatus ConstantEvaluator<Capacity>::completeArgument(PendingOperator& call)
+{
+	EvaluationStatus status;
+	const FunctionInfo& function = builtinFunctions[call.function];
+
+	if (call.arguments == function.maximumArguments)
+	{
+		status.error = EvaluationError::ArgumentCount;
+		status.offset = call.offset;
+		return status;
+	}
+
+	const OpCode step = argumentStep(function, call.arguments++);
+	return step != noStep ? emit(step, 0, call.offset) : status;
+}
+
+/*	Function:	Tokenise, shunt & calculate an expression, ending the shunt as ShuntingYard::endShunt does
+	Parameters:	1) string_view expression	- View of the string defining the expression
+	Returns:	ConstantEvaluation - Outcome & result of the evaluation
+*/
+template <size_t Capacity>
+constexpr ConstantEvaluation ConstantEvaluator<Capacity>::evaluate(std::string_view expression)
+{
+	ConstantEvaluation evaluation;
+	Lexer lexer(expression);
+	Token token = {};
+
+	while (lexer.next(token))
+	{
+		evaluation.status = shuntToken(token, lexer.text(token));
+
+		if (!evaluation.status)
+		{
+			return evaluation;
+		}
+	}
+
+	while (pendingCount > 0)
+	{
+		const PendingOperator pending = pendingOperators[--pendingCount];
+
+		if (pending.kind == TokenKind::LeftParenthesis)
+		{
+			evaluation.status.error = EvaluationError::MismatchedParenthesis;
+			evaluation.status.offset = pending.offset;
+			return evaluation;
+		}
+
+		if (pending.kind == TokenKind::Function)
+		{
+			evaluation.status.error = EvaluationError::ArgumentCount;
+			evaluation.status.offset = pending.offset;
+			return evaluation;
+		}
+
+		evaluation.status = emit(operatorTable[pending.operatorIndex].opCode, 0, pending.offset);
+
+		if (!evaluation.status)
+		{
+			return evaluation;
+		}
+	}
+
+	// Nothing to calculate
+	if (emitted == 0)
+	{
+		evaluation.status.error = EvaluationError::EmptyExpression;
+		return evaluation;
+	}
+
+	if (verification && depth > 1)
+	{
+		verification.error = EvaluationError::MissingOperator;
+		verification.offset = secondValueOffset;
+	}
+
+	evaluation.status = !verification ? verification : calculation;
+	evaluation.value = values[0];
+	return evaluation;
+}
+
+/*	Function:	- Evaluate a literal expression in a constant expression
+				- Every token is at least one character, so a Capacity of the expression's
+					length always suffices
+	Parameters:	1) string_view expression	- View of the string defining the expression
+	Returns:	ConstantEvaluation - Outcome & result of the evaluation
+*/
+template <size_t Capacity>
+constexpr ConstantEvaluation evaluateConstant(std::string_view expression)
+{
+	ConstantEvaluator<Capacity> evaluator;
+	return evaluator.evaluate(expression);
+}
+
+/*	Function:	- Deliberately not constexpr: reaching it during constant evaluation
+					stops compilation, naming this function in the diagnostic
+	Returns:	int
+*/
+inline int invalidConstantExpression() { return 0; }
+
+/*	Function:	Value of a successful constant evaluation; a compile error otherwise
+	Parameters:	1) ConstantEvaluation ref evaluation	- Evaluation to unwrap
+	Returns:	int
+*/
+constexpr int requireConstant(const ConstantEvaluation& evaluation)
+{
+	return evaluation ? evaluation.value : invalidConstantExpression();
+}
+
+/*	Macro:		- Value of a string literal expression, parsed & calculated by the compiler
+				- Malformed expressions fail to compile, e.g. SY_CONSTANT("( 1 + ( 12 * 2 )")
+				- Use evaluateConstant<N>() with static_assert to check the error instead
+*/
+#define SY_CONSTANT(expression) \
+	(std::integral_constant<int, requireConstant(evaluateConstant<sizeof(expression)>(expression))>::value)
+
+static_assert(SY_CONSTANT("( 4 / 2 ) + 6") == 8, "Compile-time evaluation");
+static_assert(evaluateConstant<32>("( 1 + ( 12 * 2 )").status.error == EvaluationError::MismatchedParenthesis,
+	"Compile-time error reporting");
+static_assert(SY_CONSTANT("clamp ( max ( 3 , -7 , 12 ) , 0 , abs ( -10 ) )") == 10, "Compile-time function calls");
+#pragma endregion
+
+#pragma region RPN Calculation
+class RPN
+{
+	public:
+		bool calculatePostfix(const std::vector<std::string>& inputTokens, int& result);
+		EvaluationStatus calculatePostfix(const Instruction* program, size_t instructionCount, int& result,
+			const int* variables = nullptr);
+
+		// Pre-size the value stack for programs of up to the given length
+		void reserve(size_t instructionCount) { if (valueSlots.size() < instructionCount) valueSlots.resize(instructionCount); }
+
+		// Values the scratch stack can hold without allocating
+		size_t capacity() const { return valueSlots.capacity(); }
+
+	private:
+		std::stack<int> valueStack;		// Holds values for Postfix calculations
+		std::vector<int> valueSlots;	// Fixed-capacity value stack for bytecode calculations;
+										//		capacity is reused between calls
+};
+
+/*	Function:	Calculate the result of an expression written in postfix notation
+	Parameters:	1) Vector<string> ref inputTokens	- Reference to collection of postfix-ordered tokens
+				2) int ref result					- Reference to the variable for storing results
+													- Pass-by-reference used to directly modify the
+														result value to be displayed withotu having to return
+														a value & allows the method to return true/false for
+														a successfuly calculation
+	Returns: 1) bool	- Whether or not the calculation was successful
+*/
+bool RPN::calculatePostfix(const std::vector<std::string>& inputTokens, int& result)
+{
+	// Discard anything left behind by an earlier calculation
+	valueStack = std::stack<int>();
+
+	// Iterate over each given input token
+	// Integer checked first as we know the integers are,
+	//		ordered before operators thanks to Shunting Yard
+	for (int i = 0; i < inputTokens.size(); i++)
+	{
+		const std::string currentToken = inputTokens[i];					// Cache the current token
+
+		// Check if token is integer
+		if (verifyInteger(currentToken))
+		{
+			// Convert string to integer,
+			//		push to stack of values
+			valueStack.push(std::stoi(currentToken));
+		}
+
+		// Check if token is an operator
+		else if (isOperator(currentToken))
+		{
+			// All operators require two arguements
+			// Check if there are enough values on the stack
 			// If enough values
 			if (valueStack.size() >= 2)
 			{
-				// Check which operator is currently selected
-				// Pop required arguments off the value stack
-				// Perform operation
-				int arg1;
-				int arg2;
+				// Check which operator is currently selected
+				// Pop required arguments off the value stack
+				// Perform operation
+				int arg1;
+				int arg2;
+
+				if (currentToken == "+")
+				{				
+					arg1 = valueStack.top();
+					valueStack.pop();
+					arg2 = valueStack.top();
+					valueStack.pop();
+
+					// Place the result back on top of the stack,
+					//		to use in future operations
+					int tmpResult = addValues(arg1, arg2);
+					valueStack.push(tmpResult);
+				}
+
+				else if (currentToken == "-")
+				{
+					arg1 = valueStack.top();
+					valueStack.pop();
+					arg2 = valueStack.top();
+					valueStack.pop();
+
+					// Place the result back on top of the stack,
+					//		to use in future operations
+					// arg2 given first as the order for the subtraction is
+					//		reversed when placed on the stack
+					int tmpResult = subtractValues(arg2, arg1);
+					valueStack.push(tmpResult);
+				}
+
+				else if (currentToken == "*")
+				{
+					arg1 = valueStack.top();
+					valueStack.pop();
+					arg2 = valueStack.top();
+					valueStack.pop();
+
+					// Place the result back on top of the stack,
+					//		to use in future operations
+					int tmpResult = multiplyValues(arg1, arg2);
+					valueStack.push(tmpResult);
+				}
+				
+				if (currentToken == "/")
+				{
+					arg1 = valueStack.top();
+					valueStack.pop();
+					arg2 = valueStack.top();
+					valueStack.pop();
+
+					// Place the result back on top of the stack,
+					//		to use in future operations
+					// arg2 given first as the order for the division is
+					//		reversed when placed on the stack
+					int tmpResult = 0;
+
+					if (divideIntegers(arg2, arg1, tmpResult) != EvaluationError::None)
+					{
+						SY_LOG("Division by zero. Evaluation failed \n");
+						return false;
+					}
+
+					valueStack.push(tmpResult);
+				}
+			}
+
+			else
+			{
+				// Operation failed, return false
+				SY_LOG("Not enough arguements. Evaluation failed \n");
+				return false;
+			}
+		}
+
+		// Otherwise, something is wrong
+		else
+		{
+			SY_LOG("Invalid expression. Returning 0.");
+			return false;
+		}
+
+	} // End for() loop - Iteration over input tokens
+
+	// Exactly one value must be left; none means an empty expression,
+	//		more means values with no operator to combine them
+	if (valueStack.size() != 1)
+	{
+		SY_LOG("Invalid expression. Returning 0.");
+		return false;
+	}
+
+	// Set final result
+	// Return true; successful evaluation
+	result = valueStack.top();
+	return true;
+}
+
+/*	Function:	- Calculate the result of a verified postfix program
+				- Interpreter loop over bytecode without any string handling
+				- The program must have passed verifyProgram (as every program produced by
+					ShuntingYard::shuntInfixToRPN has), so the stack depth at each instruction
+					is known to be in range & no bounds are checked while running
+	Parameters:	1) Instruction ptr program		- Pointer to the first instruction to run
+				2) size_t instructionCount		- Number of instructions in the program
+				3) int ref result				- Reference to the variable for storing results
+				4) int ptr variables			- Values of the program's variables, indexed by slot
+												- May be null for programs without variables
+	Returns: 1) EvaluationStatus	- Whether or not the calculation was successful
+									- On failure, offset holds the index of the failing instruction
+*/
+EvaluationStatus RPN::calculatePostfix(const Instruction* program, size_t instructionCount, int& result,
+	const int* variables)
+{
+	EvaluationStatus status;
+
+	// The stack can never hold more values than there are instructions
+	// Once warm, no allocation takes place
+	reserve(instructionCount);
+
+	int* values = valueSlots.data();
+	size_t depth = 0;
+
+	for (size_t i = 0; i < instructionCount; i++)
+	{
+		const Instruction& instruction = program[i];
+
+		switch (instruction.opCode)
+		{
+			// Constants are pushed straight onto the value stack
+			case OpCode::PushConstant:
+				values[depth++] = instruction.operand;
+				break;
+
+			// Variables are read from the caller's values
+			case OpCode::PushVariable:
+				if (variables == nullptr)
+				{
+					SY_LOG("Unbound variable. Evaluation failed \n");
+					status.error = EvaluationError::UnboundVariable;
+					status.offset = static_cast<unsigned int>(i);
+					return status;
+				}
+
+				values[depth++] = variables[instruction.operand];
+				break;
+
+			// Negation replaces the value on top of the stack
+			case OpCode::Negate:
+				values[depth - 1] = negateValue(values[depth - 1], 0);
+				break;
+
+			case OpCode::Absolute:
+				values[depth - 1] = absoluteValue(values[depth - 1], 0);
+				break;
+
+			// Registered functions read their arguments in place & leave their result
+			//		in the first argument's slot
+			case OpCode::Call:
+				depth -= callArity(instruction.operand);
+				status.error = invokeFunction(instruction.operand, values + depth);
+				depth++;
+
+				if (!status)
+				{
+					status.offset = static_cast<unsigned int>(i);
+					return status;
+				}
+
+				break;
+
+			// Pop required arguments off the value stack,
+			//		placing the result back on top of the stack
+			default:
+				depth--;
+				status.error = applyOperator(instruction.opCode, values[depth - 1], values[depth], values[depth - 1]);
+
+				if (!status)
+				{
+					status.offset = static_cast<unsigned int>(i);
+					return status;
+				}
+
+				break;
+		}
+	} // End for() loop - Iteration over instructions
+
+	// Verified programs leave exactly one value
+	result = values[0];
+	return status;
+}
+#pragma endregion
+
+#pragma region Evaluation Context
+/*	Class:		- Reusable scratch state for reentrant, allocation-free evaluation
+				- Owns the operator stack, program buffer & value stack used to
+					parse, shunt & calculate an expression
+				- Buffers only ever grow; once warmed up by an expression at least
+					as long as the next one, evaluation performs no heap allocation
+				- A context must only be used by one thread at a time; everything
+					else the engine touches is either immutable or per-call, so
+					threads with their own context never contend
+*/
+class EvaluationContext
+{
+	public:
+		// Pre-size every buffer for expressions of up to the given length
+		void reserve(size_t expressionLength);
+
+		// Work done through this context; all zero unless SHUNTING_YARD_STATS is defined
+		const EvaluationStats& stats() const { return statistics; }
+		void resetStats() { statistics = EvaluationStats(); }
+
+	private:
+		friend EvaluationStatus compile(std::string_view expression, CompiledExpression& compiled);
+		friend EvaluationStatus evaluate(std::string_view expression, EvaluationContext& context, int& result);
+		friend EvaluationStatus evaluate(const CompiledExpression& compiled, const int* variables, EvaluationContext& context, int& result);
+		friend EvaluationStatus evaluate(const ProgramFile& file, size_t index, const int* variables, EvaluationContext& context, int& result);
+		friend EvaluationStatus evaluateBatch(const CompiledExpression& compiled, const int* const* columns, size_t rowCount,
+			int* results, EvaluationStatus* statuses, EvaluationContext& context);
+
+		template <typename Value>
+		friend EvaluationStatus compile(std::string_view expression, TypedExpression<Value>& compiled);
+
+		// Bytes of scratch buffer held across the shunter, value stack, program & batch buffers
+		size_t capacity() const
+		{
+			return shunter.capacity() + (rpn.capacity() + batchSlots.capacity() + batchRow.capacity()) * sizeof(int)
+				+ program.capacity() * sizeof(Instruction);
+		}
+
+		void recordShunt();
+		void recordOutcome(const EvaluationStatus& status, size_t capacityBefore);
+
+		ShuntingYard shunter;					// Holds the reusable operator stack
+		RPN rpn;								// Holds the reusable value stack
+		std::vector<Instruction> program;		// Program buffer for uncompiled evaluations
+		std::vector<int> batchSlots;			// evaluateBatch's block of rows per stack slot
+		std::vector<int> batchRow;				// Variables of one row, when evaluateBatch retries a block row by row
+		EvaluationStats statistics;				// Instrumentation counters
+};
+
+/*	Function:	Pre-size every scratch buffer so the first evaluation does not allocate either
+	Parameters:	1) size_t expressionLength	- Length of the longest expression to be evaluated
+	Returns:	void
+*/
+void EvaluationContext::reserve(size_t expressionLength)
+{
+	shunter.reserve(expressionLength);
+	rpn.reserve(expressionLength);
+	program.reserve(expressionLength);
+}
+
+/*	Function:	Add the shunter's counters for the last shunt to the statistics
+	Returns:	void
+*/
+void EvaluationContext::recordShunt()
+{
+	statistics.tokens += shunter.tokensShunted();
+	statistics.maximumOperatorDepth = std::max(statistics.maximumOperatorDepth, shunter.operatorStackPeak());
+}
+
+/*	Function:	Count a finished call's failure, if any, & whether its scratch buffers had to grow
+	Parameters:	1) EvaluationStatus ref status		- Outcome of the call
+				2) size_t capacityBefore			- capacity() when the call began
+	Returns:	void
+*/
+void EvaluationContext::recordOutcome(const EvaluationStatus& status, size_t capacityBefore)
+{
+	if (!status)
+	{
+		statistics.failures[static_cast<size_t>(status.error)]++;
+	}
+
+	if (capacity() > capacityBefore)
+	{
+		statistics.bufferGrowths++;
+	}
+}
+
+/*	Function:	- Scratch context belonging to the calling thread
+				- Used by the overloads that do not take a context, so they neither
+					share state between threads nor rebuild it on every call
+	Returns:	EvaluationContext ref
+*/
+EvaluationContext& threadContext()
+{
+	thread_local EvaluationContext context;
+	return context;
+}
+
+/*	Function:	- Evaluates a string-based mathematical expression using caller-provided scratch
+				- Tokenises, shunts & calculates without any heap allocation once warm
+
+	Parameters:	1) string_view expression			- View of the string defining the expression
+				2) EvaluationContext ref context	- Reference to the scratch buffers to use
+				3) Int ref result					- Reference to the variable for storing results
+
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus evaluate(std::string_view expression, EvaluationContext& context, int& result)
+{
+	SY_STATS_LOCAL(const size_t, capacityBefore, context.capacity());
+	SY_STATS_LOCAL(const std::chrono::steady_clock::time_point, parseStart, std::chrono::steady_clock::now());
+
+	context.program.clear();
+
+	// Tokenise & shunt into the context's program buffer
+	EvaluationStatus status = context.shunter.shuntInfixToRPN(expression, context.program);
+
+	SY_STATS(context.statistics.evaluations++;
+		context.statistics.parseNanoseconds += elapsedNanoseconds(parseStart);
+		context.recordShunt());
+
+	if (!status)
+	{
+		SY_LOG("\n Shunt failed \n");
+		SY_STATS(context.recordOutcome(status, capacityBefore));
+		return status;
+	}
+
+	SY_STATS_LOCAL(const std::chrono::steady_clock::time_point, calculateStart, std::chrono::steady_clock::now());
+	status = context.rpn.calculatePostfix(context.program.data(), context.program.size(), result);
+
+	SY_STATS(context.statistics.calculateNanoseconds += elapsedNanoseconds(calculateStart);
+		context.statistics.instructions += context.program.size();
+		context.statistics.maximumValueDepth = std::max(context.statistics.maximumValueDepth,
+			measureStackDepth(context.program.data(), context.program.size())));
+
+	// Report evaluation errors against the token that caused them
+	if (!status && status.offset < context.shunter.offsets().size())
+	{
+		status.offset = context.shunter.offsets()[status.offset];
+	}
+
+	SY_STATS(context.recordOutcome(status, capacityBefore));
+	return status;
+}
+#pragma endregion
+
+#pragma region Optimisation
+/*	Function:	- Check that every operator of a program has the operands it pops
+				- Shunted programs are already verified; this guards optimiseProgram &
+					NativeProgram::compile against hand-built ones
+	Parameters:	1) Instruction ptr program		- Pointer to the first instruction
+				2) size_t instructionCount		- Number of instructions in the program
+	Returns:	bool - True if the program leaves exactly one value without underflowing
+*/
+bool isWellFormed(const Instruction* program, size_t instructionCount)
+{
+	size_t depth = 0;
+
+	for (size_t i = 0; i < instructionCount; i++)
+	{
+		const unsigned char arity = instructionArity(program[i]);
+
+		if (depth < arity)
+		{
+			return false;
+		}
+
+		depth = depth - arity + 1;
+	}
+
+	return depth == 1;
+}
+
+/*	Function:	- Fold a binary operator applied to two constants
+				- Overflow & INT_MIN / -1 fold to the wrapped value, as the interpreters give it
+				- Refuses division by zero, leaving the operator in the program to report its
+					error at run time with its own source offset
+	Parameters:	1) OpCode opCode	- Operator to apply
+				2) int lhs			- Left-hand constant
+				3) int rhs			- Right-hand constant
+				4) int ref value	- Receives the folded constant
+	Returns:	bool - Whether or not the operator could be folded
+*/
+bool foldConstants(OpCode opCode, int lhs, int rhs, int& value)
+{
+	switch (opCode)
+	{
+		case OpCode::Add:		value = addValues(lhs, rhs); return true;
+		case OpCode::Subtract:	value = subtractValues(lhs, rhs); return true;
+		case OpCode::Multiply:	value = multiplyValues(lhs, rhs); return true;
+		case OpCode::Minimum:	value = minimumValue(lhs, rhs); return true;
+		case OpCode::Maximum:	value = maximumValue(lhs, rhs); return true;
+		case OpCode::Divide:	return divideIntegers(lhs, rhs, value) == EvaluationError::None;
+
+		default:
+			return false;
+	}
+}
+
+/*	Function:	- Whether a constant leaves the other operand of a binary operator unchanged
+	Parameters:	1) OpCode opCode		- Operator being applied
+				2) int constant			- Value of the constant operand
+				3) bool constantIsLhs	- True if the constant is the left-hand operand
+	Returns:	bool - True for x + 0, 0 + x, x - 0, x * 1, 1 * x & x / 1
+*/
+bool isIdentity(OpCode opCode, int constant, bool constantIsLhs)
+{
+	switch (opCode)
+	{
+		case OpCode::Add:		return constant == 0;
+		case OpCode::Multiply:	return constant == 1;
+		case OpCode::Subtract:	return constant == 0 && !constantIsLhs;
+		case OpCode::Divide:	return constant == 1 && !constantIsLhs;
+		default:				return false;
+	}
+}
+
+/*	Function:	- Shorten a postfix program between shunting & evaluation
+				- Folds constant subexpressions, so ( 4 / 2 ) + 6 becomes a single push
+				- Drops identities such as x * 1 & x + 0, and double negations
+				- Calls to registered functions are never folded; they are kept as written
+				- Rewrites the program in place in a single pass, tracking the
+					output range each value on the stack was produced by
+				- Malformed programs & operators that would fail at run time (such as
+					division by a constant zero) are left as they are
+	Parameters:	1) Vector<Instruction> ref program		- Reference to the program to optimise
+				2) Vector<unsigned int> ref offsets		- Reference to the source offset of each instruction;
+															kept parallel to the program
+	Returns:	size_t - Number of instructions removed
+*/
+size_t optimiseProgram(std::vector<Instruction>& program, std::vector<unsigned int>& offsets)
+{
+	if (!isWellFormed(program.data(), program.size()))
+	{
+		return 0;
+	}
+
+	// Value produced by program[start, end of the output so far)
+	struct StackValue
+	{
+		size_t start;		// Index of the value's first instruction in the output
+		bool constant;		// Whether the value is a single PushConstant
+	};
+
+	std::vector<StackValue> values;
+	values.reserve(program.size());
+
+	// Instructions are only ever removed, so the output never overtakes the input
+	size_t written = 0;
+
+	for (size_t i = 0; i < program.size(); i++)
+	{
+		const Instruction instruction = program[i];
+		const unsigned char arity = instructionArity(instruction);
+
+		// Calls replace their arguments with one value of their own
+		if (instruction.opCode == OpCode::Call)
+		{
+			const size_t start = arity > 0 ? values[values.size() - arity].start : written;
+			values.resize(values.size() - arity);
+			values.push_back({ start, false });
+			program[written] = instruction;
+			offsets[written] = offsets[i];
+			written++;
+			continue;
+		}
+
+		if (arity == 0)
+		{
+			values.push_back({ written, instruction.opCode == OpCode::PushConstant });
+			program[written] = instruction;
+			offsets[written] = offsets[i];
+			written++;
+			continue;
+		}
+
+		if (arity == 1)
+		{
+			StackValue& operand = values.back();
+			const bool negate = instruction.opCode == OpCode::Negate;
+
+			// -c & abs ( c ) fold into the constant, wrapping for INT_MIN
+			if (operand.constant)
+			{
+				int& constant = program[operand.start].operand;
+				constant = negate ? negateValue(constant, 0) : absoluteValue(constant, 0);
+				continue;
+			}
+
+			// - - x is x; the operand's last instruction is the output's last
+			if (negate && !operand.constant && program[written - 1].opCode == OpCode::Negate)
+			{
+				written--;
+				continue;
+			}
+
+			// abs ( abs ( x ) ) is abs ( x )
+			if (!negate && !operand.constant && program[written - 1].opCode == OpCode::Absolute)
+			{
+				continue;
+			}
+
+			program[written] = instruction;
+			offsets[written] = offsets[i];
+			written++;
+			continue;
+		}
+
+		const StackValue rhs = values.back();
+		values.pop_back();
+		StackValue& lhs = values.back();
+		int value = 0;
+
+		// Both operands are constants; replace all three instructions with one push
+		if (lhs.constant && rhs.constant
+			&& foldConstants(instruction.opCode, program[lhs.start].operand, program[rhs.start].operand, value))
+		{
+			program[lhs.start].operand = value;
+			written = lhs.start + 1;
+			continue;
+		}
+
+		// x op c where c leaves x unchanged; drop the constant & the operator
+		if (rhs.constant && isIdentity(instruction.opCode, program[rhs.start].operand, false))
+		{
+			written = rhs.start;
+			continue;
+		}
+
+		// c op x where c leaves x unchanged; drop the constant, shifting x down into its place
+		if (lhs.constant && isIdentity(instruction.opCode, program[lhs.start].operand, true))
+		{
+			std::move(program.begin() + rhs.start, program.begin() + written, program.begin() + lhs.start);
+			std::move(offsets.begin() + rhs.start, offsets.begin() + written, offsets.begin() + lhs.start);
+			written--;
+			lhs.constant = rhs.constant;
+			continue;
+		}
+
+		program[written] = instruction;
+		offsets[written] = offsets[i];
+		written++;
+		lhs.constant = false;
+	}
+
+	const size_t removed = program.size() - written;
+	program.resize(written);
+	offsets.resize(written);
+	return removed;
+}
+#pragma endregion
+
+#pragma region Native Compilation
+/*	Native code generation
+	- Compiled programs that are evaluated often enough are lowered to x86-64 machine code,
+		removing the interpreter's per-instruction dispatch
+	- Only available on x86-64 platforms with mmap; elsewhere, or when SHUNTING_YARD_NO_JIT
+		is defined, every program stays on the interpreter
+*/
+
+// Deepest value stack lowered to native code; each value beneath the top costs 8 bytes of machine stack
+constexpr size_t maximumNativeStackDepth = 16384;
+
+/*	Class:		- Executable machine code for a single postfix program
+				- The top of the value stack lives in eax & the values beneath it on the
+					machine stack, so most instructions are one or two machine instructions
+				- Code is written to a read/write mapping which is then made read/execute,
+					so memory is never writable & executable at once
+				- Signature: int function(const int* variables, unsigned int* failedInstruction)
+					- On division by zero, failedInstruction receives the index of the
+						divide & the function returns 0; otherwise it is left untouched
+*/
+class NativeProgram
+{
+	public:
+		typedef int (*Function)(const int* variables, unsigned int* failedInstruction);
+
+		NativeProgram() = default;
+		NativeProgram(const NativeProgram&) = delete;
+		NativeProgram& operator=(const NativeProgram&) = delete;
+		~NativeProgram() { release(); }
+
+		bool compile(const Instruction* program, size_t instructionCount);
+
+		// Entry point of the generated code, or null if nothing has been compiled
+		Function function() const { return entry; }
+
+	private:
+		void release();
+
+		void* code = nullptr;		// Executable mapping holding the generated code
+		size_t codeSize = 0;		// Size of the mapping in bytes
+		Function entry = nullptr;	// code, as a callable function
+};
+
+/*	Function:	- Lower a postfix program to x86-64 machine code (System V calling convention)
+				- Only well-formed programs of a bounded stack depth are lowered; anything
+					else is left to the interpreter, which reports its errors as before
+	Parameters:	1) Instruction ptr program		- Pointer to the first instruction
+				2) size_t instructionCount		- Number of instructions in the program
+	Returns:	bool - Whether or not native code was generated
+*/
+bool NativeProgram::compile(const Instruction* program, size_t instructionCount)
+{
+	release();
+
+#ifdef SHUNTING_YARD_HAS_JIT
+	if (!isWellFormed(program, instructionCount)
+		|| measureStackDepth(program, instructionCount) > maximumNativeStackDepth)
+	{
+		return false;
+	}
+
+	std::vector<unsigned char> bytes;
+	bytes.reserve(instructionCount * 12 + 16);
+
+	auto emit = [&](std::initializer_list<unsigned char> code) { bytes.insert(bytes.end(), code); };
+	auto emit32 = [&](unsigned int value)
+	{
+		for (int shift = 0; shift < 32; shift += 8)
+		{
+			bytes.push_back(static_cast<unsigned char>(value >> shift));
+		}
+	};
+
+	// Divides jump to a stub recording their instruction index when the divisor is zero
+	struct DivisionCheck
+	{
+		size_t jumpOffset;			// Offset of the jz rel32 displacement to patch
+		unsigned int instruction;	// Index of the divide in the program
+	};
+
+	std::vector<DivisionCheck> divisionChecks;
+
+	// mov r9, rsp - remembered so a failed divide can discard the values pushed so far
+	emit({ 0x49, 0x89, 0xE1 });
+
+	size_t depth = 0;
+
+	for (size_t i = 0; i < instructionCount; i++)
+	{
+		const Instruction& instruction = program[i];
+
+		switch (instruction.opCode)
+		{
+			case OpCode::PushConstant:
+				if (depth++ > 0)
+				{
+					emit({ 0x50 });								// push rax
+				}
+
+				emit({ 0xB8 });									// mov eax, imm32
+				emit32(static_cast<unsigned int>(instruction.operand));
+				break;
+
+			case OpCode::PushVariable:
+				if (depth++ > 0)
+				{
+					emit({ 0x50 });								// push rax
+				}
+
+				emit({ 0x8B, 0x87 });							// mov eax, [rdi + disp32]
+				emit32(static_cast<unsigned int>(instruction.operand) * sizeof(int));
+				break;
+
+			case OpCode::Negate:
+				emit({ 0xF7, 0xD8 });							// neg eax
+				break;
+
+			case OpCode::Absolute:
+				emit({ 0x89, 0xC1, 0xF7, 0xD8 });				// mov ecx, eax; neg eax
+				emit({ 0x0F, 0x48, 0xC1 });						// cmovs eax, ecx
+				break;
+
+			case OpCode::Minimum:
+				emit({ 0x59, 0x39, 0xC1, 0x0F, 0x4C, 0xC1 });	// pop rcx; cmp ecx, eax; cmovl eax, ecx
+				depth--;
+				break;
+
+			case OpCode::Maximum:
+				emit({ 0x59, 0x39, 0xC1, 0x0F, 0x4F, 0xC1 });	// pop rcx; cmp ecx, eax; cmovg eax, ecx
+				depth--;
+				break;
+
+			case OpCode::Add:
+				emit({ 0x59, 0x01, 0xC8 });						// pop rcx; add eax, ecx
+				depth--;
+				break;
+
+			case OpCode::Subtract:
+				emit({ 0x59, 0x29, 0xC1, 0x89, 0xC8 });			// pop rcx; sub ecx, eax; mov eax, ecx
+				depth--;
+				break;
+
+			case OpCode::Multiply:
+				emit({ 0x59, 0x0F, 0xAF, 0xC1 });				// pop rcx; imul eax, ecx
+				depth--;
+				break;
+
+			case OpCode::Divide:
+				emit({ 0x59, 0x85, 0xC0, 0x0F, 0x84 });			// pop rcx; test eax, eax; jz rel32
+				divisionChecks.push_back({ bytes.size(), static_cast<unsigned int>(i) });
+				emit32(0);
+
+				// idiv faults on INT_MIN / -1, so a -1 divisor negates instead, wrapping as the interpreter does
+				emit({ 0x83, 0xF8, 0xFF, 0x75, 0x06 });			// cmp eax, -1; jne divide
+				emit({ 0x89, 0xC8, 0xF7, 0xD8, 0xEB, 0x09 });	// mov eax, ecx; neg eax; jmp done
+				emit({ 0x41, 0x89, 0xC0, 0x89, 0xC8, 0x99 });	// divide: mov r8d, eax; mov eax, ecx; cdq
+				emit({ 0x41, 0xF7, 0xF8 });						// idiv r8d; done:
+				depth--;
+				break;
+
+			// Literal tables belong to typed programs, which are never lowered, & calls
+			//		to registered functions stay on the interpreter
+			case OpCode::PushLiteral:
+			case OpCode::Call:
+				return false;
+		}
+	}
+
+	emit({ 0xC3 });												// ret
+
+	for (size_t i = 0; i < divisionChecks.size(); i++)
+	{
+		const size_t jumpOffset = divisionChecks[i].jumpOffset;
+		const unsigned int displacement = static_cast<unsigned int>(bytes.size() - (jumpOffset + 4));
+		std::memcpy(&bytes[jumpOffset], &displacement, sizeof(displacement));
+
+		emit({ 0xC7, 0x06 });									// mov dword [rsi], imm32
+		emit32(divisionChecks[i].instruction);
+		emit({ 0x4C, 0x89, 0xCC, 0x31, 0xC0, 0xC3 });			// mov rsp, r9; xor eax, eax; ret
+	}
+
+	// Copy into a fresh mapping, then swap write access for execute access
+	void* mapping = mmap(nullptr, bytes.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (mapping == MAP_FAILED)
+	{
+		SY_LOG("Native compilation failed: could not map code");
+		return false;
+	}
+
+	std::memcpy(mapping, bytes.data(), bytes.size());
+
+	if (mprotect(mapping, bytes.size(), PROT_READ | PROT_EXEC) != 0)
+	{
+		SY_LOG("Native compilation failed: could not make code executable");
+		munmap(mapping, bytes.size());
+		return false;
+	}
+
+	code = mapping;
+	codeSize = bytes.size();
+	entry = reinterpret_cast<Function>(code);
+	return true;
+#else
+	(void)program;
+	(void)instructionCount;
+	return false;
+#endif
+}
+
+/*	Function:	Unmap any generated code
+	Returns:	void
+*/
+void NativeProgram::release()
+{
+#ifdef SHUNTING_YARD_HAS_JIT
+	if (code != nullptr)
+	{
+		munmap(code, codeSize);
+	}
+#endif
+
+	code = nullptr;
+	codeSize = 0;
+	entry = nullptr;
+}
+
+/*	Function:	- Number of evaluations after which a compiled expression is lowered to native code
+				- 0 lowers expressions on their first evaluation; UINT_MAX keeps them interpreted
+	Returns:	std::atomic<unsigned int> ref
+*/
+std::atomic<unsigned int>& jitThresholdSetting()
+{
+	static std::atomic<unsigned int> threshold(1000);
+	return threshold;
+}
+
+/*	Function:	Set the tiering threshold used by every compiled expression
+	Parameters:	1) unsigned int evaluationCount	- Evaluations before an expression is lowered to native code
+	Returns:	void
+*/
+void setJitThreshold(unsigned int evaluationCount)
+{
+	jitThresholdSetting().store(evaluationCount, std::memory_order_relaxed);
+}
+
+/*	Class:		- Tiering state of one compiled expression
+				- Counts evaluations until the threshold is passed, then lowers the program
+					to native code exactly once; later evaluations only load a pointer
+				- Safe to use from many threads at once; one thread compiles while the
+					others carry on interpreting
+				- Copies start cold, so a CompiledExpression remains copyable
+*/
+class NativeTier
+{
+	public:
+		NativeTier() = default;
+		NativeTier(const NativeTier&) {}
+		NativeTier& operator=(const NativeTier&) { reset(); return *this; }
+		~NativeTier() { reset(); }
+
+		// Whether native code has been generated
+		bool isNative() const { return native.load(std::memory_order_acquire) != nullptr; }
+
+		NativeProgram::Function enter(const Instruction* program, size_t instructionCount) const;
+
+		// Discard any native code & start counting again; not safe during evaluation
+		void reset();
+
+	private:
+		mutable std::atomic<unsigned int> evaluationCount{ 0 };
+		mutable std::atomic<bool> claimed{ false };				// Set by the thread compiling (or that failed to)
+		mutable std::atomic<NativeProgram*> native{ nullptr };	// Published once compiled
+};
+
+/*	Function:	- Count an evaluation & return the native code to run it with, if any
+				- Compiles the program on the evaluation that passes the threshold
+	Parameters:	1) Instruction ptr program		- Pointer to the first instruction
+				2) size_t instructionCount		- Number of instructions in the program
+	Returns:	NativeProgram::Function - Native entry point, or null to interpret
+*/
+NativeProgram::Function NativeTier::enter(const Instruction* program, size_t instructionCount) const
+{
+	if (const NativeProgram* compiled = native.load(std::memory_order_acquire))
+	{
+		return compiled->function();
+	}
+
+	// Already compiling on another thread, or not suitable for native code
+	if (claimed.load(std::memory_order_relaxed))
+	{
+		return nullptr;
+	}
+
+	const unsigned int threshold = jitThresholdSetting().load(std::memory_order_relaxed);
+
+	if (threshold == UINT_MAX || evaluationCount.fetch_add(1, std::memory_order_relaxed) < threshold)
+	{
+		return nullptr;
+	}
+
+	if (claimed.exchange(true, std::memory_order_relaxed))
+	{
+		return nullptr;
+	}
+
+	std::unique_ptr<NativeProgram> compiled(new NativeProgram());
+
+	if (!compiled->compile(program, instructionCount))
+	{
+		return nullptr;
+	}
+
+	const NativeProgram::Function function = compiled->function();
+	native.store(compiled.release(), std::memory_order_release);
+	return function;
+}
+
+/*	Function:	Discard any native code & start counting again
+	Returns:	void
+*/
+void NativeTier::reset()
+{
+	delete native.exchange(nullptr, std::memory_order_acquire);
+	claimed.store(false, std::memory_order_relaxed);
+	evaluationCount.store(0, std::memory_order_relaxed);
+}
+#pragma endregion
+
+#pragma region Compiled Expressions
+/*	Class:		- Ready-to-run form of an expression
+				- Holds the postfix output of the Shunting-Yard so an expression
+					only has to be tokenised & shunted once, no matter how many
+					times it is evaluated afterwards
+				- Immutable once compiled; a single instance may be evaluated by
+					any number of threads at once without locking
+				- Counts its evaluations & switches to native code once they pass
+					the JIT threshold (see setJitThreshold)
+*/
+class CompiledExpression
+{
+	public:
+		// Whether the expression was successfully compiled & can be evaluated
+		bool isValid() const { return valid; }
+
+		// Postfix program produced by ShuntingYard::shuntInfixToRPN, after optimiseProgram
+		const std::vector<Instruction>& program() const { return instructions; }
+
+		// Names of the variables read by the program; variable values are
+		//		supplied in this order
+		const std::vector<std::string>& variables() const { return variableNames; }
+
+		// Deepest value stack the program reaches
+		size_t stackDepth() const { return maximumStackDepth; }
+
+		// Character offset in the source expression of the token behind each instruction
+		const std::vector<unsigned int>& offsets() const { return sourceOffsets; }
+
+		// Whether evaluations now run as native code rather than on the interpreter
+		bool isNative() const { return tier.isNative(); }
+
+	private:
+		friend EvaluationStatus compile(std::string_view expression, CompiledExpression& compiled);
+		friend EvaluationStatus evaluate(const CompiledExpression& compiled, const int* variables, EvaluationContext& context, int& result);
+
+		std::vector<Instruction> instructions;		// Shunted postfix program
+		std::vector<unsigned int> sourceOffsets;	// Source offset of each instruction, for error reporting
+		std::vector<std::string> variableNames;		// Variable names indexed by PushVariable operands
+		size_t maximumStackDepth = 0;				// Value stack size needed to run the program
+		bool valid = false;							// Set once compile() succeeds
+		NativeTier tier;							// Evaluation count & native code, once hot
+};
+
+/*	Function:	- Compiles a string-based mathematical expression
+				- Tokenises string without copying it; whitespace between tokens is optional
+				- Applies Shunting-Yard to create postfix expression
+				- Folds constant subexpressions & drops identities with optimiseProgram
+				- Stores the postfix expression in the given CompiledExpression for reuse
+				- Shunts with the calling thread's scratch context, so it is safe to call
+					from many threads at once
+
+	Parameters:	1) string_view expression				- View of the string defining the expression
+				2) CompiledExpression ref compiled		- Reference to the object storing the compiled program
+														- Any previously compiled program is replaced
+
+	Returns:	EvaluationStatus - Whether or not the compilation was successful
+*/
+EvaluationStatus compile(std::string_view expression, CompiledExpression& compiled)
+{
+	// Reuse this thread's ShuntingYard to convert from
+	//		infix to postfix notation
+	EvaluationContext& context = threadContext();
+	ShuntingYard& shunter = context.shunter;
+
+	SY_STATS_LOCAL(const size_t, capacityBefore, context.capacity());
+	SY_STATS_LOCAL(const std::chrono::steady_clock::time_point, parseStart, std::chrono::steady_clock::now());
+
+	// Discard any previously compiled program
+	compiled.instructions.clear();
+	compiled.sourceOffsets.clear();
+	compiled.variableNames.clear();
+	compiled.maximumStackDepth = 0;
+	compiled.valid = false;
+	compiled.tier.reset();
+
+	// Tokenise & convert infix to RPN using Shunting Yard
+	// Provide Shunting Yard with the expression to convert
+	//		as well as the compiled program to store the output
+	const EvaluationStatus status = shunter.shuntInfixToRPN(expression, compiled.instructions);
+
+	SY_STATS(context.statistics.compilations++;
+		context.statistics.parseNanoseconds += elapsedNanoseconds(parseStart);
+		context.recordShunt();
+		context.recordOutcome(status, capacityBefore));
+
+	if (!status)
+	{
+		SY_LOG("\n Shunt failed \n");
+		compiled.instructions.clear();
+		return status;
+	}
+
+	// Take owned copies of the variable names, as the shunter's refer into the expression
+	compiled.sourceOffsets = shunter.offsets();
+	compiled.variableNames.assign(shunter.variables().begin(), shunter.variables().end());
+
+	// Compiled programs are run many times, so shorten them once up front
+	optimiseProgram(compiled.instructions, compiled.sourceOffsets);
+	compiled.maximumStackDepth = measureStackDepth(compiled.instructions.data(), compiled.instructions.size());
+	compiled.valid = true;
+	return status;
+}
+
+/*	Function:	- Evaluates a previously compiled expression using caller-provided scratch
+				- Only the postfix calculation is performed; no tokenising or shunting
+				- Once evaluated more than the JIT threshold, runs as native code
+				- The compiled expression is only read (besides its atomic tiering state),
+					so it may be shared between threads
+
+	Parameters:	1) CompiledExpression ref compiled	- Reference to the compiled program to run
+				2) int ptr variables				- Value of each variable, in compiled.variables() order
+													- May be null for programs without variables
+				3) EvaluationContext ref context	- Reference to the scratch buffers to use
+				4) Int ref result					- Reference to the variable for storing results
+
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus evaluate(const CompiledExpression& compiled, const int* variables, EvaluationContext& context, int& result)
+{
+	SY_STATS_LOCAL(const size_t, capacityBefore, context.capacity());
+	SY_STATS_LOCAL(const std::chrono::steady_clock::time_point, calculateStart, std::chrono::steady_clock::now());
+	SY_STATS(context.statistics.evaluations++);
+
+	EvaluationStatus status;
+
+	// Programs that failed to compile cannot be run
+	if (!compiled.isValid())
+	{
+		status.error = EvaluationError::NotCompiled;
+		SY_STATS(context.recordOutcome(status, capacityBefore));
+		return status;
+	}
+
+	// Hot programs run as native code; variables must be bound as the code reads them unchecked
+	const NativeProgram::Function native = variables != nullptr || compiled.variables().empty()
+		? compiled.tier.enter(compiled.program().data(), compiled.program().size()) : nullptr;
+
+	if (native != nullptr)
+	{
+		unsigned int failedInstruction = UINT_MAX;
+		const int value = native(variables, &failedInstruction);
+
+		if (failedInstruction != UINT_MAX)
+		{
+			status.error = EvaluationError::DivisionByZero;
+			status.offset = failedInstruction;
+		}
+
+		else
+		{
+			result = value;
+		}
+	}
+
+	// Otherwise calculate result using RPN
+	else
+	{
+		status = context.rpn.calculatePostfix(compiled.program().data(), compiled.program().size(), result, variables);
+	}
+
+	SY_STATS(context.statistics.calculateNanoseconds += elapsedNanoseconds(calculateStart);
+		context.statistics.instructions += compiled.program().size();
+		context.statistics.maximumValueDepth = std::max(context.statistics.maximumValueDepth, compiled.stackDepth()));
+
+	// Report evaluation errors against the token that caused them
+	if (!status && status.offset < compiled.offsets().size())
+	{
+		status.offset = compiled.offsets()[status.offset];
+	}
+
+	SY_STATS(context.recordOutcome(status, capacityBefore));
+	return status;
+}
+
+/*	Function:	Evaluates a previously compiled expression using caller-provided scratch
+	Parameters:	1) CompiledExpression ref compiled	- Reference to the compiled program to run
+				2) EvaluationContext ref context	- Reference to the scratch buffers to use
+				3) Int ref result					- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus evaluate(const CompiledExpression& compiled, EvaluationContext& context, int& result)
+{
+	return evaluate(compiled, nullptr, context, result);
+}
+
+/*	Function:	Evaluates a previously compiled expression using the calling thread's scratch
+	Parameters:	1) CompiledExpression ref compiled	- Reference to the compiled program to run
+				2) Int ref result					- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus evaluate(const CompiledExpression& compiled, int& result)
+{
+	return evaluate(compiled, nullptr, threadContext(), result);
+}
+
+/*	Function:	Evaluates a previously compiled expression that reads variables
+	Parameters:	1) CompiledExpression ref compiled	- Reference to the compiled program to run
+				2) int ptr variables				- Value of each variable, in compiled.variables() order
+				3) Int ref result					- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus evaluate(const CompiledExpression& compiled, const int* variables, int& result)
+{
+	return evaluate(compiled, variables, threadContext(), result);
+}
+#pragma endregion
+
+#pragma region Register Programs
+/*	Struct:		- A single instruction of a register program: destination = opCode(lhs, rhs)
+				- Operands & destinations index the evaluation frame, which holds the registers,
+					then the program's constants, then its variables, so constants & variables
+					are read in place & never pushed
+				- PushConstant is a copy of frame[lhs] into destination; it only materialises
+					call arguments & a result that is a lone constant or variable
+*/
+struct RegisterInstruction
+{
+	OpCode opCode;
+	unsigned int destination;		// Register written
+	unsigned int lhs;				// Frame slot of the only or left operand
+	unsigned int rhs;				// Frame slot of the right operand; for calls, the Call operand
+};
+
+/*	Class:		- A compiled program lowered from postfix to register form
+				- Every value lives in a fixed register; a value's register is the stack depth it
+					would have had, so registers are reused as soon as their value is consumed
+				- Evaluation reads & writes frame slots directly, with no stack pointer
+*/
+class RegisterProgram
+{
+	public:
+		EvaluationStatus lower(const CompiledExpression& compiled);
+		EvaluationStatus lower(const Instruction* program, size_t instructionCount, const unsigned int* offsets,
+			size_t variableCount);
+		EvaluationStatus evaluate(const int* variables, int& result) const;
+
+		const std::vector<RegisterInstruction>& program() const { return instructions; }
+
+		// Number of registers, i.e. the postfix program's stack depth
+		size_t registerCount() const { return registers; }
+
+		bool isValid() const { return valid; }
+
+	private:
+		EvaluationStatus run(size_t instructionCount, int* frame, int& result) const;
+
+		std::vector<RegisterInstruction> instructions;
+		std::vector<unsigned int> sourceOffsets;	// Source offset of each instruction
+		std::vector<int> constants;					// Copied into the frame after the registers
+		size_t registers = 0;
+		size_t variableSlots = 0;					// Variables that follow the constants in the frame
+		size_t unboundPrefix = 0;					// Instructions run without variables before failing
+		unsigned int unboundOffset = 0;				// Source offset of the first variable read
+		bool valid = false;
+};
+
+/*	Function:	Lower a compiled expression to register form
+	Parameters:	1) CompiledExpression ref compiled	- Compiled program to lower
+	Returns:	EvaluationStatus - NotCompiled if compiled holds no valid program
+*/
+EvaluationStatus RegisterProgram::lower(const CompiledExpression& compiled)
+{
+	if (!compiled.isValid())
+	{
+		valid = false;
+		EvaluationStatus status;
+		status.error = EvaluationError::NotCompiled;
+		return status;
+	}
+
+	return lower(compiled.program().data(), compiled.program().size(), compiled.offsets().data(), compiled.variables().size());
+}
+
+/*	Function:	- Lower a postfix program to register form
+				- Replays the program over a stack of operand locations: pushes only record where
+					their value is, & each operator writes the register of its first operand
+	Parameters:	1) Instruction ptr program		- Pointer to the first instruction
+				2) size_t instructionCount		- Number of instructions in the program
+				3) unsigned int ptr offsets		- Source offset of each instruction
+				4) size_t variableCount			- Number of variables the program may read
+	Returns:	EvaluationStatus - Stack errors as verifyProgram reports them, at their source offset;
+									InvalidToken for anything but int instructions
+*/
+EvaluationStatus RegisterProgram::lower(const Instruction* program, size_t instructionCount, const unsigned int* offsets,
+	size_t variableCount)
+{
+	EvaluationStatus status = verifyProgram(program, instructionCount);
+
+	instructions.clear();
+	sourceOffsets.clear();
+	constants.clear();
+	valid = false;
+
+	if (!status)
+	{
+		status.offset = status.offset < instructionCount ? offsets[status.offset] : 0;
+		return status;
+	}
+
+	// Constants are numbered as they are pushed; they follow the registers in the frame
+	for (size_t i = 0; i < instructionCount; i++)
+	{
+		const Instruction& instruction = program[i];
+
+		if (instruction.opCode == OpCode::PushLiteral || instruction.opCode > OpCode::Call
+			|| (instruction.opCode == OpCode::PushVariable
+				&& (instruction.operand < 0 || static_cast<size_t>(instruction.operand) >= variableCount)))
+		{
+			status.error = EvaluationError::InvalidToken;
+			status.offset = offsets[i];
+			return status;
+		}
+
+		if (instruction.opCode == OpCode::PushConstant)
+		{
+			constants.push_back(instruction.operand);
+		}
+	}
+
+	registers = measureStackDepth(program, instructionCount);
+	variableSlots = variableCount;
+	unboundPrefix = SIZE_MAX;
+
+	const unsigned int firstConstant = static_cast<unsigned int>(registers);
+	const unsigned int firstVariable = static_cast<unsigned int>(registers + constants.size());
+	std::vector<unsigned int> locations;	// Frame slot holding each value of the postfix stack
+	unsigned int constant = 0;
+
+	// Put a value into its own register, as call arguments & the result must be
+	auto materialise = [&](size_t depth, unsigned int offset)
+	{
+		if (locations[depth] != depth)
+		{
+			instructions.push_back({ OpCode::PushConstant, static_cast<unsigned int>(depth), locations[depth], locations[depth] });
+			sourceOffsets.push_back(offset);
+			locations[depth] = static_cast<unsigned int>(depth);
+		}
+	};
+
+	for (size_t i = 0; i < instructionCount; i++)
+	{
+		const Instruction& instruction = program[i];
+		const unsigned int offset = offsets[i];
+
+		switch (instruction.opCode)
+		{
+			case OpCode::PushConstant:
+				locations.push_back(firstConstant + constant++);
+				continue;
+
+			case OpCode::PushVariable:
+				// Without variables, evaluation fails here, after the instructions lowered so far
+				if (unboundPrefix == SIZE_MAX)
+				{
+					unboundPrefix = instructions.size();
+					unboundOffset = offset;
+				}
+
+				locations.push_back(firstVariable + static_cast<unsigned int>(instruction.operand));
+				continue;
+
+			case OpCode::Call:
+			{
+				const size_t base = locations.size() - callArity(instruction.operand);
+
+				for (size_t j = base; j < locations.size(); j++)
+				{
+					materialise(j, offset);
+				}
+
+				locations.resize(base + 1);
+				instructions.push_back({ OpCode::Call, static_cast<unsigned int>(base), static_cast<unsigned int>(base),
+					static_cast<unsigned int>(instruction.operand) });
+				break;
+			}
+
+			default:
+			{
+				// Unary operators read & write the top register; binary operators the lower of the two
+				const size_t arity = opCodeArity(instruction.opCode);
+				const size_t base = locations.size() - arity;
+				const unsigned int rhs = locations.back();
+
+				instructions.push_back({ instruction.opCode, static_cast<unsigned int>(base), locations[base], rhs });
+				locations.resize(base + 1);
+				locations[base] = static_cast<unsigned int>(base);
+				break;
+			}
+		}
+
+		sourceOffsets.push_back(offset);
+	}
+
+	// The result is read from register 0
+	materialise(0, offsets[instructionCount - 1]);
+
+	if (unboundPrefix == SIZE_MAX)
+	{
+		unboundPrefix = instructions.size();
+	}
+
+	valid = true;
+	return status;
+}
+
+/*	Function:	Run the first instructions of the program over a prepared frame
+	Parameters:	1) size_t instructionCount	- Number of instructions to run
+				2) int ptr frame			- Registers, constants & variables
+				3) Int ref result			- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus RegisterProgram::run(size_t instructionCount, int* frame, int& result) const
+{
+	EvaluationStatus status;
+
+	for (size_t i = 0; i < instructionCount; i++)
+	{
+		const RegisterInstruction& instruction = instructions[i];
+		int& destination = frame[instruction.destination];
+		const int lhs = frame[instruction.lhs];
+
+		// rhs is only a frame slot for binary operators
+		switch (instruction.opCode)
+		{
+			case OpCode::PushConstant:	destination = lhs; break;
+			case OpCode::Add:			destination = addValues(lhs, frame[instruction.rhs]); break;
+			case OpCode::Subtract:		destination = subtractValues(lhs, frame[instruction.rhs]); break;
+			case OpCode::Multiply:		destination = multiplyValues(lhs, frame[instruction.rhs]); break;
+			case OpCode::Minimum:		destination = minimumValue(lhs, frame[instruction.rhs]); break;
+			case OpCode::Maximum:		destination = maximumValue(lhs, frame[instruction.rhs]); break;
+			case OpCode::Negate:		destination = negateValue(lhs, 0); break;
+			case OpCode::Absolute:		destination = absoluteValue(lhs, 0); break;
+
+			case OpCode::Divide:
+				status.error = divideIntegers(lhs, frame[instruction.rhs], destination);
+				break;
+
+			case OpCode::Call:
+				status.error = invokeFunction(static_cast<int>(instruction.rhs), &destination);
+				break;
+
+			default:
+				status.error = EvaluationError::InvalidToken;
+				break;
+		}
+
+		if (status.error != EvaluationError::None)
+		{
+			status.offset = sourceOffsets[i];
+			return status;
+		}
+	}
+
+	result = frame[0];
+	return status;
+}
+
+/*	Function:	Evaluate the register program
+	Parameters:	1) int ptr variables	- Value of each variable, in the compiled variables() order
+										- May be null for programs without variables
+				2) Int ref result		- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus RegisterProgram::evaluate(const int* variables, int& result) const
+{
+	EvaluationStatus status;
+
+	if (!valid)
+	{
+		status.error = EvaluationError::NotCompiled;
+		return status;
+	}
+
+	thread_local std::vector<int> frame;
+	frame.resize(registers + constants.size() + variableSlots);
+	std::copy(constants.begin(), constants.end(), frame.begin() + registers);
+
+	if (variables == nullptr && variableSlots > 0)
+	{
+		// Run what precedes the first variable, as the postfix interpreter would
+		int partial = 0;
+		status = run(unboundPrefix, frame.data(), partial);
+
+		if (status)
+		{
+			status.error = EvaluationError::UnboundVariable;
+			status.offset = unboundOffset;
+		}
+
+		return status;
+	}
+
+	std::copy_n(variables, variableSlots, frame.begin() + registers + constants.size());
+	return run(instructions.size(), frame.data(), result);
+}
+#pragma endregion
+
+#pragma region Expression Cache
+/*	Class:		- Bounded, thread-safe cache of compiled expressions keyed by expression text
+				- Repeated expressions are looked up by string_view, skipping tokenising &
+					shunting entirely; a hit performs no heap allocation
+				- Split into independently locked shards chosen by hash, so threads looking up
+					different expressions rarely contend
+				- Each shard evicts its least recently used expression once full
+				- Expressions that fail to compile are cached too, along with their error
+				- Entries belong to a compilationGeneration(); a shard found holding an older
+					generation drops all of its entries first, so a lookup never answers with a
+					result (success or failure) compiled under limits no longer in force, or
+					before a function it calls was registered
+*/
+class ExpressionCache
+{
+	public:
+		explicit ExpressionCache(size_t capacity = 1024, unsigned int shardCount = 16);
+
+		ExpressionCache(const ExpressionCache&) = delete;
+		ExpressionCache& operator=(const ExpressionCache&) = delete;
+
+		std::shared_ptr<const CompiledExpression> find(std::string_view expression, EvaluationStatus& status);
+		EvaluationStatus evaluate(std::string_view expression, int& result);
+		EvaluationStatus evaluate(std::string_view expression, const int* variables, int& result);
+		void clear();
+
+		// Lookups answered from the cache, & those that had to compile
+		unsigned long long hits() const { return hitCount.load(std::memory_order_relaxed); }
+		unsigned long long misses() const { return missCount.load(std::memory_order_relaxed); }
+
+		// Maximum number of expressions held
+		size_t capacity() const { return shardCapacity * shardCount; }
+
+		size_t size() const;
+
+	private:
+		// A cached expression; the text is owned here & viewed by the shard's index
+		struct Entry
+		{
+			std::string text;
+			EvaluationStatus status;
+			std::shared_ptr<const CompiledExpression> compiled;
+		};
+
+		// Entries are kept most recently used first
+		struct Shard
+		{
+			mutable std::mutex lock;
+			std::list<Entry> entries;
+			std::unordered_map<std::string_view, std::list<Entry>::iterator> index;
+			unsigned long long generation = 0;		// compilationGeneration() the entries were compiled in
+		};
+
+		static void refresh(Shard& shard, unsigned long long generation);
+
+		Shard& shardFor(std::string_view expression) { return shards[std::hash<std::string_view>()(expression) % shardCount]; }
+
+		std::unique_ptr<Shard[]> shards;
+		size_t shardCount;
+		size_t shardCapacity = 1;						// Entries held per shard
+		std::atomic<unsigned long long> hitCount{ 0 };
+		std::atomic<unsigned long long> missCount{ 0 };
+};
+
+/*	Function:	Create an empty cache
+	Parameters:	1) size_t capacity				- Maximum number of expressions held; at least one per shard
+				2) unsigned int shardCount		- Number of independently locked shards; at least 1
+*/
+ExpressionCache::ExpressionCache(size_t capacity, unsigned int shardCount)
+	: shardCount(shardCount > 0 ? shardCount : 1)
+{
+	shardCapacity = std::max<size_t>((capacity + this->shardCount - 1) / this->shardCount, 1);
+	shards.reset(new Shard[this->shardCount]);
+
+	for (size_t i = 0; i < this->shardCount; i++)
+	{
+		shards[i].index.reserve(shardCapacity);
+	}
+}
+
+/*	Function:	- Look up the compiled form of an expression, compiling & caching it on a miss
+				- Compilation happens outside the shard's lock; if two threads miss on the
+					same expression at once, the first to finish is cached & shared
+	Parameters:	1) string_view expression		- View of the string defining the expression
+				2) EvaluationStatus ref status	- Receives the outcome of compiling the expression
+	Returns:	shared_ptr<const CompiledExpression> - The compiled expression; stays valid even
+													after it is evicted
+*/
+std::shared_ptr<const CompiledExpression> ExpressionCache::find(std::string_view expression, EvaluationStatus& status)
+{
+	Shard& shard = shardFor(expression);
+	const unsigned long long generation = compilationGeneration().load(std::memory_order_acquire);
+
+	{
+		std::lock_guard<std::mutex> guard(shard.lock);
+		refresh(shard, generation);
+		const auto found = shard.index.find(expression);
+
+		if (found != shard.index.end())
+		{
+			// Move to the front as the most recently used
+			shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+			hitCount.fetch_add(1, std::memory_order_relaxed);
+			status = found->second->status;
+			return found->second->compiled;
+		}
+	}
+
+	missCount.fetch_add(1, std::memory_order_relaxed);
+
+	std::shared_ptr<CompiledExpression> compiled = std::make_shared<CompiledExpression>();
+	status = compile(expression, *compiled);
+
+	std::lock_guard<std::mutex> guard(shard.lock);
+
+	// Compiled under settings that changed meanwhile; correct for this call, but not worth keeping
+	if (generation != compilationGeneration().load(std::memory_order_acquire))
+	{
+		return compiled;
+	}
+
+	refresh(shard, generation);
+	const auto found = shard.index.find(expression);
+
+	// Another thread cached it first
+	if (found != shard.index.end())
+	{
+		status = found->second->status;
+		return found->second->compiled;
+	}
+
+	if (shard.entries.size() >= shardCapacity)
+	{
+		shard.index.erase(shard.entries.back().text);
+		shard.entries.pop_back();
+	}
+
+	shard.entries.push_front({ std::string(expression), status, compiled });
+	shard.index.emplace(shard.entries.front().text, shard.entries.begin());
+	return compiled;
+}
+
+/*	Function:	Drop a shard's entries if they were compiled in an older generation; the shard must be locked
+	Parameters:	1) Shard ref shard					- Shard to check
+				2) unsigned long long generation	- compilationGeneration() of the caller
+	Returns:	void
+*/
+void ExpressionCache::refresh(Shard& shard, unsigned long long generation)
+{
+	// A caller that loaded an older generation than the shard's does not drop newer entries
+	if (shard.generation >= generation)
+	{
+		return;
+	}
+
+	shard.index.clear();
+	shard.entries.clear();
+	shard.generation = generation;
+}
+
+/*	Function:	Evaluate an expression via its cached compiled form, using the calling thread's scratch
+	Parameters:	1) string_view expression		- View of the string defining the expression
+				2) int ptr variables			- Value of each variable, in the compiled expression's
+													variables() order; may be null for none
+				3) Int ref result				- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus ExpressionCache::evaluate(std::string_view expression, const int* variables, int& result)
+{
+	EvaluationStatus status;
+	const std::shared_ptr<const CompiledExpression> compiled = find(expression, status);
+
+	if (!status)
+	{
+		return status;
+	}
+
+	return ::evaluate(*compiled, variables, threadContext(), result);
+}
+
+/*	Function:	Evaluate an expression without variables via its cached compiled form
+	Parameters:	1) string_view expression		- View of the string defining the expression
+				2) Int ref result				- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus ExpressionCache::evaluate(std::string_view expression, int& result)
+{
+	return evaluate(expression, nullptr, result);
+}
+
+/*	Function:	Number of expressions currently cached
+	Returns:	size_t
+*/
+size_t ExpressionCache::size() const
+{
+	size_t total = 0;
+
+	for (size_t i = 0; i < shardCount; i++)
+	{
+		std::lock_guard<std::mutex> guard(shards[i].lock);
+		total += shards[i].entries.size();
+	}
+
+	return total;
+}
+
+/*	Function:	Remove every cached expression & reset the counters
+	Returns:	void
+*/
+void ExpressionCache::clear()
+{
+	for (size_t i = 0; i < shardCount; i++)
+	{
+		std::lock_guard<std::mutex> guard(shards[i].lock);
+		shards[i].index.clear();
+		shards[i].entries.clear();
+	}
+
+	hitCount.store(0, std::memory_order_relaxed);
+	missCount.store(0, std::memory_order_relaxed);
+}
+#pragma endregion
+
+#pragma region Typed Expressions
+/*	Class:		- Compiled expression evaluated over a chosen value type, such as int64_t,
+					double or Checked<int64_t>
+				- Constants are parsed once, at compile time, into a literal table of
+					Values; the program refers to them with PushLiteral
+				- Immutable once compiled, so it may be shared between threads
+*/
+template <typename Value>
+class TypedExpression
+{
+	public:
+		// Whether the expression was successfully compiled & can be evaluated
+		bool isValid() const { return valid; }
+
+		// Postfix program produced by ShuntingYard::shuntInfixToRPN in literal mode
+		const std::vector<Instruction>& program() const { return instructions; }
+
+		// Constants indexed by PushLiteral operands
+		const std::vector<Value>& literals() const { return literalValues; }
+
+		// Names of the variables read by the program; variable values are supplied in this order
+		const std::vector<std::string>& variables() const { return variableNames; }
+
+		// Deepest value stack the program reaches
+		size_t stackDepth() const { return maximumStackDepth; }
+
+		// Character offset in the source expression of the token behind each instruction
+		const std::vector<unsigned int>& offsets() const { return sourceOffsets; }
+
+	private:
+		template <typename Type>
+		friend EvaluationStatus compile(std::string_view expression, TypedExpression<Type>& compiled);
+
+		std::vector<Instruction> instructions;		// Shunted postfix program
+		std::vector<Value> literalValues;			// Parsed constants
+		std::vector<unsigned int> sourceOffsets;	// Source offset of each instruction, for error reporting
+		std::vector<std::string> variableNames;		// Variable names indexed by PushVariable operands
+		size_t maximumStackDepth = 0;				// Value stack size needed to run the program
+		bool valid = false;							// Set once compile() succeeds
+};
+
+/*	Function:	- Compiles a string-based mathematical expression for a chosen value type
+				- Shunts as compile() does, then parses each constant with ValueTraits<Value>,
+					so e.g. 2.5 is only accepted when Value is floating point
+	Parameters:	1) string_view expression				- View of the string defining the expression
+				2) TypedExpression ref compiled			- Reference to the object storing the compiled program
+	Returns:	EvaluationStatus - Whether or not the compilation was successful
+*/
+template <typename Value>
+EvaluationStatus compile(std::string_view expression, TypedExpression<Value>& compiled)
+{
+	ShuntingYard& shunter = threadContext().shunter;
+
+	compiled.instructions.clear();
+	compiled.literalValues.clear();
+	compiled.sourceOffsets.clear();
+	compiled.variableNames.clear();
+	compiled.maximumStackDepth = 0;
+	compiled.valid = false;
+
+	// Leave constants as text for this value type to parse
+	shunter.setLiteralConstants(true);
+	EvaluationStatus status = shunter.shuntInfixToRPN(expression, compiled.instructions);
+	shunter.setLiteralConstants(false);
+
+	if (!status)
+	{
+		SY_LOG("\n Shunt failed \n");
+		compiled.instructions.clear();
+		return status;
+	}
+
+	compiled.literalValues.resize(shunter.literals().size());
+
+	for (size_t i = 0; i < compiled.instructions.size(); i++)
+	{
+		const Instruction& instruction = compiled.instructions[i];
+
+		// Registered functions take ints, so only built-in functions apply to other value types
+		if (instruction.opCode == OpCode::Call)
+		{
+			SY_LOG("Failure Point: Registered function in a typed expression \n");
+			status.error = EvaluationError::UnknownFunction;
+			status.offset = shunter.offsets()[i];
+			compiled.instructions.clear();
+			compiled.literalValues.clear();
+			return status;
+		}
+
+		if (instruction.opCode == OpCode::PushLiteral
+			&& !ValueTraits<Value>::parse(shunter.literals()[instruction.operand], compiled.literalValues[instruction.operand]))
+		{
+			SY_LOG("Failure Point: Invalid constant \n");
+			status.error = EvaluationError::InvalidConstant;
+			status.offset = shunter.offsets()[i];
+			compiled.instructions.clear();
+			compiled.literalValues.clear();
+			return status;
+		}
+	}
+
+	compiled.sourceOffsets = shunter.offsets();
+	compiled.variableNames.assign(shunter.variables().begin(), shunter.variables().end());
+	compiled.maximumStackDepth = measureStackDepth(compiled.instructions.data(), compiled.instructions.size());
+	compiled.valid = true;
+	return status;
+}
+
+/*	Function:	- Evaluates a typed compiled expression
+				- Follows the same rules as RPN::calculatePostfix, with the arithmetic of
+					ValueTraits<Value> inlined into the interpreter loop & no stack bounds checks
+				- Uses a per-thread value stack for each value type; no allocation once warm
+	Parameters:	1) TypedExpression ref compiled		- Reference to the compiled program to run
+				2) Value ptr variables				- Value of each variable, in compiled.variables() order
+													- May be null for programs without variables
+				3) Value ref result					- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+template <typename Value>
+EvaluationStatus evaluate(const TypedExpression<Value>& compiled, const Value* variables, Value& result)
+{
+	EvaluationStatus status;
+
+	if (!compiled.isValid())
+	{
+		status.error = EvaluationError::NotCompiled;
+		return status;
+	}
+
+	thread_local std::vector<Value> valueSlots;
+
+	if (valueSlots.size() < compiled.stackDepth())
+	{
+		valueSlots.resize(compiled.stackDepth());
+	}
+
+	const std::vector<Instruction>& program = compiled.program();
+	const Value* literals = compiled.literals().data();
+	Value* values = valueSlots.data();
+	size_t depth = 0;
+
+	for (size_t i = 0; i < program.size(); i++)
+	{
+		const Instruction& instruction = program[i];
+
+		switch (instruction.opCode)
+		{
+			case OpCode::PushLiteral:
+				values[depth++] = literals[instruction.operand];
+				continue;
+
+			case OpCode::PushVariable:
+				if (variables == nullptr)
+				{
+					status.error = EvaluationError::UnboundVariable;
+					break;
+				}
+
+				values[depth++] = variables[instruction.operand];
+				continue;
+
+			case OpCode::Negate:
+				status.error = ValueTraits<Value>::negate(values[depth - 1]);
+				break;
+
+			case OpCode::Absolute:
+				if (ValueTraits<Value>::less(values[depth - 1], Value()))
+				{
+					status.error = ValueTraits<Value>::negate(values[depth - 1]);
+				}
+
+				break;
+
+			case OpCode::Minimum:
+			case OpCode::Maximum:
+				depth--;
+
+				if (ValueTraits<Value>::less(values[depth], values[depth - 1]) == (instruction.opCode == OpCode::Minimum))
+				{
+					values[depth - 1] = values[depth];
+				}
+
+				continue;
+
+			// Typed programs are verified by the shunt, so operators always have their operands
+			default:
+				depth--;
+				status.error = ValueTraits<Value>::apply(instruction.opCode, values[depth - 1], values[depth], values[depth - 1]);
+				break;
+		}
+
+		if (!status)
+		{
+			status.offset = compiled.offsets()[i];
+			return status;
+		}
+	} // End for() loop - Iteration over instructions
+
+	result = values[0];
+	return status;
+}
+
+/*	Function:	- Evaluates a string-based mathematical expression over a chosen value type
+				- Compiles into a per-thread TypedExpression, so buffers are reused between calls
+	Parameters:	1) string_view expression	- View of the string defining the expression
+				2) Value ref result			- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+template <typename Value>
+EvaluationStatus evaluateAs(std::string_view expression, Value& result)
+{
+	thread_local TypedExpression<Value> compiled;
+	const EvaluationStatus status = compile(expression, compiled);
+
+	if (!status)
+	{
+		return status;
+	}
+
+	return evaluate(compiled, static_cast<const Value*>(nullptr), result);
+}
+#pragma endregion
+
+#pragma region Expression Graphs
+/*	Class:		- A set of related expressions lowered into one shared DAG
+				- Nodes are hash-consed: an operation over the same operands is only ever
+					added once, so subexpressions shared by many expressions (or repeated
+					within one) are calculated once per evaluation
+				- Operands of +, *, min & max are ordered canonically, so a + b & b + a share a node
+				- Calls to registered functions are never shared, as the functions need not be pure
+				- Expressions are compiled (& constant folded) before lowering
+				- Variables are the union over every expression, in order of first appearance
+*/
+class ExpressionGraph
+{
+	public:
+		EvaluationStatus add(std::string_view expression);
+		void evaluate(const int* variables, int* results, EvaluationStatus* statuses) const;
+
+		// Names of the variables read by any expression; values are supplied in this order
+		const std::vector<std::string>& variables() const { return variableNames; }
+
+		// Number of expressions added, i.e. results produced by evaluate()
+		size_t outputCount() const { return outputs.size(); }
+
+		// Number of unique operations, against the instructions the expressions have in total
+		size_t nodeCount() const { return nodes.size(); }
+		size_t instructionCount() const { return totalInstructions; }
+
+	private:
+		static constexpr unsigned int noNode = UINT_MAX;
+
+		// One unique operation; operands refer to earlier nodes, so nodes are in evaluation order
+		struct Node
+		{
+			OpCode opCode;
+			int operand;				// Constant, graph variable index, or Call operand
+			unsigned int lhs;			// Only operand of unary operators; noNode for pushes & calls
+			unsigned int rhs;			// noNode for pushes, unary operators & calls
+			unsigned int arguments;		// Call: index of its first argument node in callArguments
+
+			bool operator==(const Node& other) const
+			{
+				return opCode == other.opCode && operand == other.operand && lhs == other.lhs && rhs == other.rhs
+					&& arguments == other.arguments;
+			}
+		};
+
+		struct NodeHash
+		{
+			size_t operator()(const Node& node) const
+			{
+				size_t hash = static_cast<size_t>(node.opCode);
+				hash = hash * 1000003u ^ static_cast<unsigned int>(node.operand);
+				hash = hash * 1000003u ^ node.lhs;
+				hash = hash * 1000003u ^ node.rhs;
+				return hash;
+			}
+		};
+
+		// An added expression; kept compiled to report exact errors
+		struct Output
+		{
+			unsigned int root;							// Node holding the result
+			CompiledExpression compiled;
+			std::vector<unsigned int> variableMap;		// Graph variable index of each of compiled's variables
+		};
+
+		friend class IncrementalEvaluator;
+
+		unsigned int intern(const Node& node);
+		EvaluationStatus evaluateOutput(const Output& output, const int* variables, int& result) const;
+		void calculateNode(const Node& node, const int* variables, int* values, unsigned char* poisoned, size_t index) const;
+
+		// Call visit(operand) for each distinct node a node reads
+		template <typename Visit>
+		void forEachOperand(const Node& node, Visit visit) const
+		{
+			if (node.opCode == OpCode::Call)
+			{
+				for (unsigned int i = 0; i < callArity(node.operand); i++)
+				{
+					visit(callArguments[node.arguments + i]);
+				}
+
+				return;
+			}
+
+			if (node.lhs != noNode)
+				visit(node.lhs);
+
+			if (node.rhs != noNode && node.rhs != node.lhs)
+				visit(node.rhs);
+		}
+
+		std::vector<Node> nodes;
+		std::vector<unsigned int> callArguments;		// Argument nodes of every call, in call order
+		std::unordered_map<Node, unsigned int, NodeHash> nodeIndex;
+		std::vector<Output> outputs;
+		std::vector<std::string> variableNames;
+		size_t totalInstructions = 0;
+};
+
+/*	Function:	Find the node for an operation, adding it if it is new
+	Parameters:	1) Node ref node	- Operation to find
+	Returns:	unsigned int - Index of the node
+*/
+unsigned int ExpressionGraph::intern(const Node& node)
+{
+	const auto found = nodeIndex.find(node);
+
+	if (found != nodeIndex.end())
+	{
+		return found->second;
+	}
+
+	const unsigned int index = static_cast<unsigned int>(nodes.size());
+	nodes.push_back(node);
+	nodeIndex.emplace(node, index);
+	return index;
+}
+
+/*	Function:	- Compile an expression & merge it into the graph
+				- Its result is written at index outputCount() - 1 by evaluate()
+	Parameters:	1) string_view expression	- View of the string defining the expression
+	Returns:	EvaluationStatus - Whether or not the expression compiled; failures are not added
+*/
+EvaluationStatus ExpressionGraph::add(std::string_view expression)
+{
+	Output output;
+	const EvaluationStatus status = compile(expression, output.compiled);
+
+	if (!status)
+	{
+		return status;
+	}
+
+	// Share variables with the rest of the set by name
+	for (size_t i = 0; i < output.compiled.variables().size(); i++)
+	{
+		const std::string& name = output.compiled.variables()[i];
+		const auto found = std::find(variableNames.begin(), variableNames.end(), name);
+		output.variableMap.push_back(static_cast<unsigned int>(found - variableNames.begin()));
+
+		if (found == variableNames.end())
+		{
+			variableNames.push_back(name);
+		}
+	}
+
+	const std::vector<Instruction>& program = output.compiled.program();
+	totalInstructions += program.size();
+
+	// Replay the verified program over a stack of node indices rather than values
+	std::vector<unsigned int> stack;
+
+	for (size_t i = 0; i < program.size(); i++)
+	{
+		Node node = { program[i].opCode, 0, noNode, noNode, 0 };
+
+		switch (program[i].opCode)
+		{
+			case OpCode::PushConstant:
+				node.operand = program[i].operand;
+				break;
+
+			case OpCode::PushVariable:
+				node.operand = static_cast<int>(output.variableMap[program[i].operand]);
+				break;
+
+			case OpCode::Negate:
+			case OpCode::Absolute:
+				node.lhs = stack.back();
+				stack.pop_back();
+				break;
+
+			// Calls take their arguments off the stack in order & always get a node of their own
+			case OpCode::Call:
+			{
+				const size_t arity = callArity(program[i].operand);
+				node.operand = program[i].operand;
+				node.arguments = static_cast<unsigned int>(callArguments.size());
+				callArguments.insert(callArguments.end(), stack.end() - arity, stack.end());
+				stack.resize(stack.size() - arity);
+				stack.push_back(static_cast<unsigned int>(nodes.size()));
+				nodes.push_back(node);
+				continue;
+			}
+
+			default:
+				node.rhs = stack.back();
+				stack.pop_back();
+				node.lhs = stack.back();
+				stack.pop_back();
+
+				if ((node.opCode == OpCode::Add || node.opCode == OpCode::Multiply
+					|| node.opCode == OpCode::Minimum || node.opCode == OpCode::Maximum) && node.rhs < node.lhs)
+				{
+					std::swap(node.lhs, node.rhs);
+				}
+
+				break;
+		}
+
+		stack.push_back(intern(node));
+	}
+
+	output.root = stack.back();
+
+	outputs.push_back(std::move(output));
+	return status;
+}
+
+/*	Function:	Evaluate one output from its compiled form, binding its variables from the graph's
+	Parameters:	1) Output ref output		- Output to evaluate
+				2) int ptr variables		- Values of the graph's variables
+				3) Int ref result			- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus ExpressionGraph::evaluateOutput(const Output& output, const int* variables, int& result) const
+{
+	if (variables == nullptr || output.variableMap.empty())
+	{
+		return ::evaluate(output.compiled, variables, result);
+	}
+
+	thread_local std::vector<int> bound;
+	bound.resize(output.variableMap.size());
+
+	for (size_t i = 0; i < output.variableMap.size(); i++)
+	{
+		bound[i] = variables[output.variableMap[i]];
+	}
+
+	return ::evaluate(output.compiled, bound.data(), result);
+}
+
+/*	Function:	- Calculate one node from its operands
+				- A node is poisoned if an operand is, or if its own operation fails
+	Parameters:	1) Node ref node				- Node to calculate
+				2) int ptr variables			- Values of the graph's variables; may be null
+				3) int ptr values				- Value of every node; receives the node's
+				4) unsigned char ptr poisoned	- Poison flag of every node; receives the node's
+				5) size_t index					- Index of the node
+	Returns:	void
+*/
+void ExpressionGraph::calculateNode(const Node& node, const int* variables, int* values, unsigned char* poisoned, size_t index) const
+{
+	switch (node.opCode)
+	{
+		case OpCode::PushConstant:
+			values[index] = node.operand;
+			poisoned[index] = 0;
+			break;
+
+		case OpCode::PushVariable:
+			poisoned[index] = variables == nullptr;
+			values[index] = variables == nullptr ? 0 : variables[node.operand];
+			break;
+
+		case OpCode::Negate:
+			poisoned[index] = poisoned[node.lhs];
+			values[index] = poisoned[index] ? 0 : negateValue(values[node.lhs], 0);
+			break;
+
+		case OpCode::Absolute:
+			poisoned[index] = poisoned[node.lhs];
+			values[index] = poisoned[index] ? 0 : absoluteValue(values[node.lhs], 0);
+			break;
+
+		// Gather the arguments, which are scattered through the graph, into one array
+		case OpCode::Call:
+		{
+			const unsigned int arity = callArity(node.operand);
+			int arguments[maximumFunctionArguments + 1];
+			poisoned[index] = 0;
+
+			for (unsigned int i = 0; i < arity; i++)
+			{
+				arguments[i] = values[callArguments[node.arguments + i]];
+				poisoned[index] |= poisoned[callArguments[node.arguments + i]];
+			}
+
+			if (poisoned[index] || invokeFunction(node.operand, arguments) != EvaluationError::None)
+			{
+				poisoned[index] = 1;
+				arguments[0] = 0;
+			}
+
+			values[index] = arguments[0];
+			break;
+		}
+
+		default:
+			poisoned[index] = poisoned[node.lhs] | poisoned[node.rhs];
+
+			if (poisoned[index] || applyOperator(node.opCode, values[node.lhs], values[node.rhs], values[index]) != EvaluationError::None)
+			{
+				poisoned[index] = 1;
+				values[index] = 0;
+			}
+
+			break;
+	}
+}
+
+/*	Function:	- Evaluate every expression in the set in one pass over the graph
+				- Each node is calculated once; a failing node (e.g. division by zero)
+					poisons everything that depends on it, & the outputs it reaches are
+					re-run from their compiled form to report the exact error & offset
+				- Only reads the graph, so one graph may be evaluated by many threads at once
+	Parameters:	1) int ptr variables				- Value of each variable, in variables() order
+													- May be null if no expression has variables
+				2) int ptr results					- Receives outputCount() results, in the order added
+				3) EvaluationStatus ptr statuses	- Receives outputCount() statuses; may be null
+	Returns:	void
+*/
+void ExpressionGraph::evaluate(const int* variables, int* results, EvaluationStatus* statuses) const
+{
+	thread_local std::vector<int> values;
+	thread_local std::vector<unsigned char> poisoned;
+	values.resize(nodes.size());
+	poisoned.resize(nodes.size());
+
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		calculateNode(nodes[i], variables, values.data(), poisoned.data(), i);
+	}
+
+	for (size_t i = 0; i < outputs.size(); i++)
+	{
+		const Output& output = outputs[i];
+		EvaluationStatus status;
+
+		if (!poisoned[output.root])
+		{
+			results[i] = values[output.root];
+		}
+
+		else
+		{
+			status = evaluateOutput(output, variables, results[i]);
+		}
+
+		if (statuses != nullptr)
+		{
+			statuses[i] = status;
+		}
+	}
+}
+
+/*	Class:		- Spreadsheet-style evaluation of an ExpressionGraph whose inputs change a few at a time
+				- Records which nodes read each node & which outputs each node is the result of,
+					so setting a variable only recalculates the nodes that depend on it
+				- Recalculation stops at any node whose value comes out unchanged
+				- The graph must outlive the evaluator & must not be added to while in use
+*/
+class IncrementalEvaluator
+{
+	public:
+		explicit IncrementalEvaluator(const ExpressionGraph& graph);
+
+		void setVariable(size_t index, int value);
+		void update();
+
+		// Result & status of each output as of the last update()
+		int result(size_t output) const { return results[output]; }
+		EvaluationStatus status(size_t output) const { return statuses[output]; }
+
+		// Outputs recalculated by the last update(); their results may or may not have changed
+		const std::vector<unsigned int>& updatedOutputs() const { return refreshed; }
+
+		// Nodes recalculated by the last update(), against the graph's total
+		size_t updatedNodeCount() const { return recalculated; }
+
+	private:
+		void refreshOutput(unsigned int output);
+		void queueOutput(unsigned int output);
+
+		const ExpressionGraph& graph;
+		std::vector<int> variables;					// Current value of each graph variable
+		std::vector<int> values;					// Current value of each node
+		std::vector<unsigned char> poisoned;		// Whether each node's calculation failed
+		std::vector<int> results;
+		std::vector<EvaluationStatus> statuses;
+
+		// Dependents of node i are dependents[dependentStart[i], dependentStart[i + 1])
+		std::vector<unsigned int> dependentStart;
+		std::vector<unsigned int> dependents;
+
+		std::vector<std::vector<unsigned int>> nodeOutputs;		// Outputs rooted at each node
+		std::vector<unsigned int> variableNodes;				// Node reading each variable, if any
+
+		// Pending work, kept between updates so their capacity is reused
+		std::vector<unsigned int> dirtyVariables;
+		std::vector<unsigned int> queue;			// Min-heap of node indices, so nodes run in graph order
+		std::vector<unsigned char> queued;
+		std::vector<unsigned char> outputQueued;
+		std::vector<unsigned int> outputQueue;
+		std::vector<unsigned int> refreshed;
+		size_t recalculated = 0;
+};
+
+/*	Function:	- Record the graph's dependencies & evaluate every output with all variables 0
+	Parameters:	1) ExpressionGraph ref graph	- Graph to evaluate
+*/
+IncrementalEvaluator::IncrementalEvaluator(const ExpressionGraph& graph)
+	: graph(graph),
+	variables(graph.variables().size(), 0),
+	values(graph.nodes.size(), 0),
+	poisoned(graph.nodes.size(), 0),
+	results(graph.outputs.size(), 0),
+	statuses(graph.outputs.size()),
+	nodeOutputs(graph.nodes.size()),
+	variableNodes(graph.variables().size(), ExpressionGraph::noNode),
+	queued(graph.nodes.size(), 0),
+	outputQueued(graph.outputs.size(), 0)
+{
+	const size_t nodeCount = graph.nodes.size();
+
+	// Count each node's dependents, then lay them out contiguously
+	dependentStart.assign(nodeCount + 1, 0);
+
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		const ExpressionGraph::Node& node = graph.nodes[i];
+		graph.forEachOperand(node, [&](unsigned int operand) { dependentStart[operand + 1]++; });
+
+		if (node.opCode == OpCode::PushVariable)
+			variableNodes[node.operand] = static_cast<unsigned int>(i);
+	}
+
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		dependentStart[i + 1] += dependentStart[i];
+	}
+
+	std::vector<unsigned int> filled(dependentStart.begin(), dependentStart.end() - 1);
+	dependents.resize(dependentStart[nodeCount]);
+
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		graph.forEachOperand(graph.nodes[i], [&](unsigned int operand) { dependents[filled[operand]++] = static_cast<unsigned int>(i); });
+	}
+
+	for (size_t i = 0; i < graph.outputs.size(); i++)
+	{
+		nodeOutputs[graph.outputs[i].root].push_back(static_cast<unsigned int>(i));
+	}
+
+	// Initial full evaluation
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		graph.calculateNode(graph.nodes[i], variables.data(), values.data(), poisoned.data(), i);
+	}
+
+	for (size_t i = 0; i < graph.outputs.size(); i++)
+	{
+		refreshOutput(static_cast<unsigned int>(i));
+	}
+
+	refreshed.clear();
+	recalculated = nodeCount;
+}
+
+/*	Function:	- Change the value of one input; nothing is recalculated until update()
+				- Setting a variable to its current value does nothing
+	Parameters:	1) size_t index	- Variable index, in the graph's variables() order
+				2) int value	- New value of the variable
+	Returns:	void
+*/
+void IncrementalEvaluator::setVariable(size_t index, int value)
+{
+	if (variables[index] == value)
+	{
+		return;
+	}
+
+	variables[index] = value;
+	dirtyVariables.push_back(static_cast<unsigned int>(index));
+}
+
+/*	Function:	Mark an output to be refreshed at the end of the update
+	Parameters:	1) unsigned int output	- Index of the output
+	Returns:	void
+*/
+void IncrementalEvaluator::queueOutput(unsigned int output)
+{
+	if (!outputQueued[output])
+	{
+		outputQueued[output] = 1;
+		outputQueue.push_back(output);
+	}
+}
+
+/*	Function:	Re-read an output's result from its root node, or re-interpret it
+	Parameters:	1) unsigned int output	- Index of the output
+	Returns:	void
+*/
+void IncrementalEvaluator::refreshOutput(unsigned int output)
+{
+	const ExpressionGraph::Output& entry = graph.outputs[output];
+
+	if (!poisoned[entry.root])
+	{
+		results[output] = values[entry.root];
+		statuses[output] = EvaluationStatus();
+	}
+
+	else
+	{
+		statuses[output] = graph.evaluateOutput(entry, variables.data(), results[output]);
+	}
+
+	refreshed.push_back(output);
+}
+
+/*	Function:	- Recalculate everything that depends on the variables set since the last update
+				- Nodes are recalculated in graph order, each at most once, so every node
+					sees its operands' new values
+	Returns:	void
+*/
+void IncrementalEvaluator::update()
+{
+	refreshed.clear();
+	recalculated = 0;
+
+	const std::greater<unsigned int> later;
+
+	for (size_t i = 0; i < dirtyVariables.size(); i++)
+	{
+		const unsigned int variable = dirtyVariables[i];
+		const unsigned int node = variableNodes[variable];
+
+		if (node != ExpressionGraph::noNode && !queued[node])
+		{
+			queued[node] = 1;
+			queue.push_back(node);
+			std::push_heap(queue.begin(), queue.end(), later);
+		}
+	}
+
+	dirtyVariables.clear();
+
+	while (!queue.empty())
+	{
+		std::pop_heap(queue.begin(), queue.end(), later);
+		const unsigned int node = queue.back();
+		queue.pop_back();
+		queued[node] = 0;
+
+		const int previousValue = values[node];
+		const unsigned char previousPoison = poisoned[node];
+		graph.calculateNode(graph.nodes[node], variables.data(), values.data(), poisoned.data(), node);
+		recalculated++;
+
+		// An unchanged node cannot change anything above it; poisoned nodes always
+		//		pass the change on, as their outputs' errors are found by re-interpreting
+		if (values[node] == previousValue && poisoned[node] == previousPoison && !poisoned[node])
+		{
+			continue;
+		}
+
+		for (size_t i = 0; i < nodeOutputs[node].size(); i++)
+		{
+			queueOutput(nodeOutputs[node][i]);
+		}
+
+		for (unsigned int i = dependentStart[node]; i < dependentStart[node + 1]; i++)
+		{
+			const unsigned int dependent = dependents[i];
+
+			if (!queued[dependent])
+			{
+				queued[dependent] = 1;
+				queue.push_back(dependent);
+				std::push_heap(queue.begin(), queue.end(), later);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < outputQueue.size(); i++)
+	{
+		outputQueued[outputQueue[i]] = 0;
+		refreshOutput(outputQueue[i]);
+	}
+
+	outputQueue.clear();
+}
+#pragma endregion
+
+#pragma region Batch Evaluation
+// Number of rows processed by each column kernel call
+// Small enough for a block of every stack slot to stay in cache
+const size_t batchBlockSize = 256;
+
+/*	Functions:	- Column kernels applying one operator across a block of rows
+				- Follow the same operand order as RPN::calculatePostfix; lhs holds the
+					values beneath the top of the stack & rhs the values on top of it
+				- Written as plain, branch-free loops over non-aliasing arrays so the
+					compiler vectorises add/sub/mul/negate; division has no vector
+					instruction & runs one lane at a time
+	Parameters:	1) int ptr lhs		- Left-hand operands; overwritten with the results
+				2) int ptr rhs		- Right-hand operands
+				3) size_t count		- Number of rows in the block
+	Returns:	void; divideColumns returns false instead of dividing if any divisor is zero
+*/
+void addColumns(int* __restrict lhs, const int* __restrict rhs, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		lhs[i] = addValues(lhs[i], rhs[i]);
+}
+
+void subtractColumns(int* __restrict lhs, const int* __restrict rhs, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		lhs[i] = subtractValues(lhs[i], rhs[i]);
+}
+
+void multiplyColumns(int* __restrict lhs, const int* __restrict rhs, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		lhs[i] = multiplyValues(lhs[i], rhs[i]);
+}
+
+bool divideColumns(int* __restrict lhs, const int* __restrict rhs, size_t count)
+{
+	// Reject the whole block up front rather than branching per lane
+	if (std::find(rhs, rhs + count, 0) != rhs + count)
+		return false;
+
+	// MIN / -1 wraps per lane, as the scalar operators do
+	for (size_t i = 0; i < count; i++)
+		lhs[i] = wrappingDivide(lhs[i], rhs[i]);
+
+	return true;
+}
+
+void minimumColumns(int* __restrict lhs, const int* __restrict rhs, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		lhs[i] = minimumValue(lhs[i], rhs[i]);
+}
+
+void maximumColumns(int* __restrict lhs, const int* __restrict rhs, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		lhs[i] = maximumValue(lhs[i], rhs[i]);
+}
+
+void negateColumn(int* __restrict operand, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		operand[i] = negateValue(operand[i], 0);
+}
+
+void absoluteColumn(int* __restrict operand, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		operand[i] = absoluteValue(operand[i], 0);
+}
+
+/*	Function:	- Call a registered function once per row of a block
+				- The arguments of each row are gathered from their stack slots first,
+					as the function expects them side by side
+	Parameters:	1) int operand			- Operand of the Call instruction
+				2) int ptr arguments	- Block of the first argument's slot; receives the results
+				3) size_t count			- Number of rows in the block
+	Returns:	EvaluationError - The first error reported by the function, if any
+*/
+EvaluationError callColumns(int operand, int* arguments, size_t count)
+{
+	const unsigned int arity = callArity(operand);
+	int row[maximumFunctionArguments + 1];
+
+	for (size_t i = 0; i < count; i++)
+	{
+		for (unsigned int j = 0; j < arity; j++)
+		{
+			row[j] = arguments[j * batchBlockSize + i];
+		}
+
+		const EvaluationError error = invokeFunction(operand, row);
+
+		if (error != EvaluationError::None)
+		{
+			return error;
+		}
+
+		arguments[i] = row[0];
+	}
+
+	return EvaluationError::None;
+}
+
+/*	Function:	- Run a compiled expression over one block of rows with the column kernels
+				- Fails the whole block on the first row that fails; evaluateBatch then runs the
+					block row by row for each row's own status
+	Parameters:	1) Instruction vector ref program	- Verified program to run
+				2) int ptr ptr columns				- One column per variable; may be null for none
+				3) size_t firstRow					- First row of the block
+				4) size_t count						- Number of rows in the block, at most batchBlockSize
+				5) int ptr slots					- Stack slots; one block of rows per slot
+				6) int ptr results					- Receives the block's results, from firstRow on
+	Returns:	bool - Whether or not every row of the block evaluated
+*/
+bool runBatchBlock(const std::vector<Instruction>& program, const int* const* columns, size_t firstRow, size_t count,
+	int* slots, int* results)
+{
+	size_t depth = 0;
+
+	for (size_t i = 0; i < program.size(); i++)
+	{
+		const Instruction& instruction = program[i];
+
+		if (instruction.opCode == OpCode::PushConstant)
+		{
+			std::fill_n(&slots[depth++ * batchBlockSize], count, instruction.operand);
+			continue;
+		}
+
+		if (instruction.opCode == OpCode::PushVariable)
+		{
+			if (columns == nullptr)
+			{
+				return false;
+			}
+
+			std::copy_n(columns[instruction.operand] + firstRow, count, &slots[depth++ * batchBlockSize]);
+			continue;
+		}
+
+		if (instruction.opCode == OpCode::Negate)
+		{
+			negateColumn(&slots[(depth - 1) * batchBlockSize], count);
+			continue;
+		}
+
+		if (instruction.opCode == OpCode::Absolute)
+		{
+			absoluteColumn(&slots[(depth - 1) * batchBlockSize], count);
+			continue;
+		}
+
+		if (instruction.opCode == OpCode::Call)
+		{
+			depth -= callArity(instruction.operand);
+
+			if (callColumns(instruction.operand, &slots[depth++ * batchBlockSize], count) != EvaluationError::None)
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		// Compiled programs are verified, so operators always have their operands
+		int* lhs = &slots[(depth - 2) * batchBlockSize];
+		const int* rhs = &slots[(depth - 1) * batchBlockSize];
+		depth--;
+
+		switch (instruction.opCode)
+		{
+			case OpCode::Add:		addColumns(lhs, rhs, count); break;
+			case OpCode::Subtract:	subtractColumns(lhs, rhs, count); break;
+			case OpCode::Multiply:	multiplyColumns(lhs, rhs, count); break;
+			case OpCode::Minimum:	minimumColumns(lhs, rhs, count); break;
+			case OpCode::Maximum:	maximumColumns(lhs, rhs, count); break;
+			case OpCode::Divide:
+				if (!divideColumns(lhs, rhs, count))
+				{
+					return false;
+				}
+
+				break;
+
+			default:
+				return false;
+		}
+	} // End for() loop - Iteration over instructions
+
+	// The one value left is the result for each row
+	std::copy_n(&slots[0], count, results + firstRow);
+	return true;
+}
+
+/*	Function:	- Evaluates a compiled expression over many rows of columnar variable data
+				- Each instruction is applied to a whole block of rows at a time rather
+					than running the scalar interpreter once per row
+				- Rows are independent: a failing row (e.g. a zero divisor) gets its own status &
+					a result of 0, and every other row is still evaluated. Only the block holding
+					it is re-run row by row, through the scalar interpreter
+				- Scratch comes from the context, so a warm context evaluates without allocating
+	Parameters:	1) CompiledExpression ref compiled	- Reference to the compiled program to run
+				2) int ptr ptr columns				- One column per variable, in compiled.variables() order;
+														each holding rowCount values
+														- May be null for programs without variables
+				3) size_t rowCount					- Number of rows to evaluate
+				4) int ptr results					- Output buffer receiving rowCount results
+				5) EvaluationStatus ptr statuses	- Receives rowCount statuses, one per row; may be null
+				6) EvaluationContext ref context	- Reference to the scratch buffers to use
+	Returns:	EvaluationStatus - NotCompiled, else the status of the first row that failed, if any
+*/
+EvaluationStatus evaluateBatch(const CompiledExpression& compiled, const int* const* columns, size_t rowCount, int* results,
+	EvaluationStatus* statuses, EvaluationContext& context)
+{
+	EvaluationStatus status;
+
+	if (!compiled.isValid())
+	{
+		status.error = EvaluationError::NotCompiled;
+
+		for (size_t row = 0; statuses != nullptr && row < rowCount; row++)
+		{
+			statuses[row] = status;
+		}
+
+		return status;
+	}
+
+	const std::vector<Instruction>& program = compiled.program();
+	const size_t variableCount = compiled.variables().size();
+
+	// One block of rows for every stack slot the program can use
+	context.batchSlots.resize(compiled.stackDepth() * batchBlockSize);
+	context.batchRow.resize(variableCount);
+
+	for (size_t firstRow = 0; firstRow < rowCount; firstRow += batchBlockSize)
+	{
+		const size_t count = std::min(batchBlockSize, rowCount - firstRow);
+
+		if (runBatchBlock(program, columns, firstRow, count, context.batchSlots.data(), results))
+		{
+			for (size_t row = 0; statuses != nullptr && row < count; row++)
+			{
+				statuses[firstRow + row] = EvaluationStatus();
+			}
+
+			continue;
+		}
+
+		// Some row of the block failed; find each row's own status & offset
+		for (size_t row = firstRow; row < firstRow + count; row++)
+		{
+			for (size_t j = 0; columns != nullptr && j < variableCount; j++)
+			{
+				context.batchRow[j] = columns[j][row];
+			}
+
+			const int* rowVariables = columns != nullptr ? context.batchRow.data() : nullptr;
+			const EvaluationStatus rowStatus = evaluate(compiled, rowVariables, context, results[row]);
+
+			if (!rowStatus)
+			{
+				results[row] = 0;
+
+				if (status)
+				{
+					status = rowStatus;
+				}
+			}
+
+			if (statuses != nullptr)
+			{
+				statuses[row] = rowStatus;
+			}
+		}
+	} // End for() loop - Iteration over row blocks
+
+	return status;
+}
+
+/*	Function:	Evaluates a compiled expression over many rows of columnar data, using the calling thread's scratch
+	Parameters:	As for evaluateBatch with a context
+	Returns:	EvaluationStatus - NotCompiled, else the status of the first row that failed, if any
+*/
+EvaluationStatus evaluateBatch(const CompiledExpression& compiled, const int* const* columns, size_t rowCount, int* results,
+	EvaluationStatus* statuses)
+{
+	return evaluateBatch(compiled, columns, rowCount, results, statuses, threadContext());
+}
+#pragma endregion
+
+#pragma region Program Arenas
+/*	Class:		- A formula set whose compiled programs are packed into one struct-of-arrays arena
+				- Opcodes, operands & destination stack slots each live in their own contiguous
+					array, with every formula's instructions back to back, so evaluating the whole
+					set walks each array once from front to back
+				- Each instruction's stack slot is resolved when it is added, so evaluation keeps
+					no stack pointer: an operator combines slots slot & slot + 1 into slot
+				- Variables are shared with the rest of the set by name; values are supplied in
+					variables() order
+				- Source offsets are in an array of their own, read only to report errors
+				- Sits alongside CompiledExpression, which keeps the Instruction layout
+*/
+class ProgramArena
+{
+	public:
+		EvaluationStatus add(std::string_view expression);
+		EvaluationStatus add(const CompiledExpression& compiled);
+
+		void evaluate(const int* variables, int* results, EvaluationStatus* statuses, size_t rowCount = 1) const;
+		EvaluationStatus evaluate(size_t index, const int* variables, int& result) const;
+
+		// Names of the variables read by any formula; values are supplied in this order
+		const std::vector<std::string>& variables() const { return variableNames; }
+
+		// Number of formulas added, i.e. results produced per row by evaluate()
+		size_t size() const { return formulas.size(); }
+
+		// Number of instructions packed into the arena
+		size_t instructionCount() const { return count; }
+
+	private:
+		// A formula's range of the arena
+		struct Formula
+		{
+			unsigned int firstInstruction;
+			unsigned int instructionCount;
+		};
+
+		void grow(size_t required);
+		EvaluationStatus run(const Formula& formula, const int* variables, int* values, int& result) const;
+		bool runBlock(const Formula& formula, const int* variables, size_t rowCount, int* values,
+			int* results, size_t resultStride) const;
+
+		// One allocation holding capacity operands, then capacity slots, then capacity opcodes
+		std::unique_ptr<unsigned char[]> arena;
+		size_t count = 0;								// Instructions in use
+		size_t capacity = 0;							// Instructions the arena can hold
+		int* operands = nullptr;						// Constant, set variable index or Call operand
+		uint32_t* slots = nullptr;						// Stack slot each instruction writes
+		OpCode* opCodes = nullptr;
+
+		std::vector<unsigned int> sourceOffsets;		// Source offset of each instruction
+		std::vector<Formula> formulas;
+		std::vector<std::string> variableNames;
+		size_t maximumDepth = 0;						// Deepest stack of any formula
+};
+
+/*	Function:	Compile an expression & append it to the set
+	Parameters:	1) string_view expression	- Expression to add
+	Returns:	EvaluationStatus - Whether or not the expression compiled; failures are not added
+*/
+EvaluationStatus ProgramArena::add(std::string_view expression)
+{
+	CompiledExpression compiled;
+	const EvaluationStatus status = compile(expression, compiled);
+	return status ? add(compiled) : status;
+}
+
+/*	Function:	Append a compiled expression to the set
+	Parameters:	1) CompiledExpression ref compiled	- Compiled program to copy into the arena
+	Returns:	EvaluationStatus - NotCompiled if compiled holds no valid program
+*/
+EvaluationStatus ProgramArena::add(const CompiledExpression& compiled)
+{
+	EvaluationStatus status;
+	const std::vector<Instruction>& program = compiled.program();
+
+	if (!compiled.isValid())
+	{
+		status.error = EvaluationError::NotCompiled;
+		return status;
+	}
+
+	// Share variables with the rest of the set by name
+	std::vector<int> variableMap;
+
+	for (const std::string& name : compiled.variables())
+	{
+		const auto found = std::find(variableNames.begin(), variableNames.end(), name);
+		variableMap.push_back(static_cast<int>(found - variableNames.begin()));
+
+		if (found == variableNames.end())
+		{
+			variableNames.push_back(name);
+		}
+	}
+
+	grow(count + program.size());
+	formulas.push_back({ static_cast<unsigned int>(count), static_cast<unsigned int>(program.size()) });
+	sourceOffsets.insert(sourceOffsets.end(), compiled.offsets().begin(), compiled.offsets().end());
+
+	// Replay the verified program's stack depth to find the slot each instruction writes
+	size_t depth = 0;
+
+	for (const Instruction& instruction : program)
+	{
+		depth = depth - instructionArity(instruction) + 1;
+		maximumDepth = std::max(maximumDepth, depth);
+
+		opCodes[count] = instruction.opCode;
+		operands[count] = instruction.opCode == OpCode::PushVariable ? variableMap[instruction.operand] : instruction.operand;
+		slots[count] = static_cast<uint32_t>(depth - 1);
+		count++;
+	}
+
+	return status;
+}
+
+/*	Function:	- Make room for at least the given number of instructions
+				- The arena doubles, moving each array into the new allocation
+	Parameters:	1) size_t required	- Number of instructions the arena must hold
+	Returns:	void
+*/
+void ProgramArena::grow(size_t required)
+{
+	if (required <= capacity)
+	{
+		return;
+	}
+
+	const size_t newCapacity = std::max(required, capacity * 2);
+
+	std::unique_ptr<unsigned char[]> newArena(new unsigned char[newCapacity * (sizeof(int) + sizeof(uint32_t) + sizeof(OpCode))]);
+	int* newOperands = reinterpret_cast<int*>(newArena.get());
+	uint32_t* newSlots = reinterpret_cast<uint32_t*>(newArena.get() + newCapacity * sizeof(int));
+	OpCode* newOpCodes = reinterpret_cast<OpCode*>(newArena.get() + newCapacity * (sizeof(int) + sizeof(uint32_t)));
+
+	std::copy_n(operands, count, newOperands);
+	std::copy_n(slots, count, newSlots);
+	std::copy_n(opCodes, count, newOpCodes);
+
+	arena = std::move(newArena);
+	operands = newOperands;
+	slots = newSlots;
+	opCodes = newOpCodes;
+	capacity = newCapacity;
+}
+
+/*	Function:	Run one formula's instructions
+	Parameters:	1) Formula ref formula		- Range of the arena to run
+				2) int ptr variables		- Value of each variable, in variables() order
+				3) int ptr values			- Stack slots; at least maximumDepth of them
+				4) Int ref result			- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus ProgramArena::run(const Formula& formula, const int* variables, int* values, int& result) const
+{
+	EvaluationStatus status;
+	const size_t end = formula.firstInstruction + formula.instructionCount;
+	size_t i = formula.firstInstruction;
+
+	// Only pushes of unbound variables, divisions & calls can fail; they leave the loop to report it
+	for (; i < end; i++)
+	{
+		int* slot = values + slots[i];
+
+		switch (opCodes[i])
+		{
+			case OpCode::PushConstant:	*slot = operands[i]; break;
+			case OpCode::Add:			slot[0] = addValues(slot[0], slot[1]); break;
+			case OpCode::Subtract:		slot[0] = subtractValues(slot[0], slot[1]); break;
+			case OpCode::Multiply:		slot[0] = multiplyValues(slot[0], slot[1]); break;
+			case OpCode::Minimum:		slot[0] = minimumValue(slot[0], slot[1]); break;
+			case OpCode::Maximum:		slot[0] = maximumValue(slot[0], slot[1]); break;
+			case OpCode::Negate:		*slot = negateValue(*slot, 0); break;
+			case OpCode::Absolute:		*slot = absoluteValue(*slot, 0); break;
+
+			case OpCode::PushVariable:
+				if (variables == nullptr)
+				{
+					status.error = EvaluationError::UnboundVariable;
+					break;
+				}
+
+				*slot = variables[operands[i]];
+				break;
+
+			case OpCode::Divide:
+				status.error = divideIntegers(slot[0], slot[1], slot[0]);
+				break;
+
+			case OpCode::Call:
+				status.error = invokeFunction(operands[i], slot);
+				break;
+
+			default:
+				status.error = EvaluationError::InvalidToken;
+				break;
+		}
+
+		if (status.error != EvaluationError::None)
+		{
+			status.offset = sourceOffsets[i];
+			return status;
+		}
+	}
+
+	result = values[0];
+	return status;
+}
+
+/*	Function:	- Run one formula's instructions over a block of rows, as evaluateBatch does
+				- Each slot holds batchBlockSize values, one per row
+	Parameters:	1) Formula ref formula		- Range of the arena to run
+				2) int ptr variables		- rowCount rows of variables().size() values each
+				3) size_t rowCount			- Number of rows, at most batchBlockSize
+				4) int ptr values			- Stack slots; at least maximumDepth blocks of them
+				5) int ptr results			- Receives the result of the first row
+				6) size_t resultStride		- Distance between the results of consecutive rows
+	Returns:	bool - False if any row failed; the block must then be run row by row for its statuses
+*/
+bool ProgramArena::runBlock(const Formula& formula, const int* variables, size_t rowCount, int* values,
+	int* results, size_t resultStride) const
+{
+	const size_t end = formula.firstInstruction + formula.instructionCount;
+	const size_t variableCount = variableNames.size();
+
+	for (size_t i = formula.firstInstruction; i < end; i++)
+	{
+		int* slot = values + slots[i] * batchBlockSize;
+		const int* next = slot + batchBlockSize;
+
+		switch (opCodes[i])
+		{
+			case OpCode::PushConstant:	std::fill_n(slot, rowCount, operands[i]); break;
+			case OpCode::Add:			addColumns(slot, next, rowCount); break;
+			case OpCode::Subtract:		subtractColumns(slot, next, rowCount); break;
+			case OpCode::Multiply:		multiplyColumns(slot, next, rowCount); break;
+			case OpCode::Minimum:		minimumColumns(slot, next, rowCount); break;
+			case OpCode::Maximum:		maximumColumns(slot, next, rowCount); break;
+			case OpCode::Negate:		negateColumn(slot, rowCount); break;
+			case OpCode::Absolute:		absoluteColumn(slot, rowCount); break;
+
+			case OpCode::PushVariable:
+				if (variables == nullptr)
+				{
+					return false;
+				}
+
+				for (size_t row = 0; row < rowCount; row++)
+				{
+					slot[row] = variables[row * variableCount + operands[i]];
+				}
+
+				break;
+
+			case OpCode::Divide:
+				if (!divideColumns(slot, next, rowCount))
+				{
+					return false;
+				}
+
+				break;
+
+			case OpCode::Call:
+				if (callColumns(operands[i], slot, rowCount) != EvaluationError::None)
+				{
+					return false;
+				}
+
+				break;
+
+			default:
+				return false;
+		}
+	}
+
+	for (size_t row = 0; row < rowCount; row++)
+	{
+		results[row * resultStride] = values[row];
+	}
+
+	return true;
+}
+
+/*	Function:	- Evaluate every formula of the set over one or more rows of variables
+				- A single row walks the arena once, in formula order
+				- Several rows are evaluated a block at a time, applying each instruction to
+					the whole block so its dispatch is shared by every row
+	Parameters:	1) int ptr variables				- rowCount rows of variables().size() values each
+														- May be null for sets without variables
+				2) int ptr results					- Receives rowCount rows of size() results
+				3) EvaluationStatus ptr statuses	- Receives a status per result; may be null
+				4) size_t rowCount					- Number of rows to evaluate
+	Returns:	void
+*/
+void ProgramArena::evaluate(const int* variables, int* results, EvaluationStatus* statuses, size_t rowCount) const
+{
+	thread_local std::vector<int> values;
+	values.resize(maximumDepth * (rowCount > 1 ? batchBlockSize : 1));
+
+	for (size_t firstRow = 0; firstRow < rowCount; firstRow += batchBlockSize)
+	{
+		const size_t blockRows = std::min(batchBlockSize, rowCount - firstRow);
+		const int* blockVariables = variables != nullptr ? variables + firstRow * variableNames.size() : nullptr;
+
+		for (size_t i = 0; i < formulas.size(); i++)
+		{
+			int* blockResults = results + firstRow * formulas.size() + i;
+
+			if (blockRows > 1 && runBlock(formulas[i], blockVariables, blockRows, values.data(), blockResults, formulas.size()))
+			{
+				for (size_t row = 0; statuses != nullptr && row < blockRows; row++)
+				{
+					statuses[(firstRow + row) * formulas.size() + i] = EvaluationStatus();
+				}
+
+				continue;
+			}
+
+			// One row, or a block with a failing row; find each row's own status
+			for (size_t row = 0; row < blockRows; row++)
+			{
+				const int* rowVariables = blockVariables != nullptr ? blockVariables + row * variableNames.size() : nullptr;
+				const EvaluationStatus status = run(formulas[i], rowVariables, values.data(), blockResults[row * formulas.size()]);
+
+				if (statuses != nullptr)
+				{
+					statuses[(firstRow + row) * formulas.size() + i] = status;
+				}
+			}
+		}
+	}
+}
+
+/*	Function:	Evaluate a single formula of the set
+	Parameters:	1) size_t index				- Index of the formula, in the order added
+				2) int ptr variables		- Value of each variable, in variables() order
+				3) Int ref result			- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus ProgramArena::evaluate(size_t index, const int* variables, int& result) const
+{
+	thread_local std::vector<int> values;
+	values.resize(maximumDepth);
+	return run(formulas[index], variables, values.data(), result);
+}
+#pragma endregion
+
+#pragma region Bulk Evaluation
+/*	Class:		- Evaluates large numbers of independent expressions across a pool of threads
+				- Each worker owns a contiguous range of the input & an EvaluationContext,
+					so evaluation itself shares no state between threads
+				- Idle workers steal the back half of another worker's remaining range,
+					keeping every thread busy when expression costs vary
+				- Results & statuses are written by index, so they are always in input order
+*/
+class BulkEvaluator
+{
+	public:
+		explicit BulkEvaluator(unsigned int threadCount = 0);
+		~BulkEvaluator();
+
+		BulkEvaluator(const BulkEvaluator&) = delete;
+		BulkEvaluator& operator=(const BulkEvaluator&) = delete;
+
+		void evaluateAll(const std::string_view* expressions, size_t count, int* results, EvaluationStatus* statuses);
+
+		unsigned int threadCount() const { return static_cast<unsigned int>(threads.size()); }
+
+		EvaluationStats stats() const;
+
+	private:
+		// Number of expressions a worker claims from its range at a time
+		static constexpr size_t chunkSize = 32;
+
+		// Per-thread range of outstanding work & scratch state
+		struct Worker
+		{
+			std::mutex rangeLock;			// Guards next & end against thieves
+			size_t next = 0;				// First unclaimed expression
+			size_t end = 0;					// One past the last expression in the range
+			EvaluationContext context;		// Reused for every expression the worker evaluates
+		};
+
+		void run(unsigned int index);
+		bool claimWork(Worker& worker, size_t& first, size_t& last);
+		bool stealWork(unsigned int thiefIndex);
+
+		std::vector<std::unique_ptr<Worker>> workers;
+		std::vector<std::thread> threads;
+
+		// Current job; guarded by jobLock
+		std::mutex jobLock;
+		std::condition_variable jobStarted;
+		std::condition_variable jobFinished;
+		const std::string_view* jobExpressions = nullptr;
+		int* jobResults = nullptr;
+		EvaluationStatus* jobStatuses = nullptr;
+		unsigned long long jobGeneration = 0;		// Incremented for every new job
+		unsigned int activeWorkers = 0;				// Workers still running the current job
+		bool stopping = false;
+};
+
+/*	Function:	- Instrumentation counters summed over every worker's context
+				- Only call between jobs; workers update their counters while evaluating
+	Returns:	EvaluationStats - All zero unless SHUNTING_YARD_STATS is defined
+*/
+EvaluationStats BulkEvaluator::stats() const
+{
+	EvaluationStats total;
+
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		total.add(workers[i]->context.stats());
+	}
+
+	return total;
+}
+
+/*	Function:	Start the worker threads
+	Parameters:	1) unsigned int threadCount	- Number of worker threads; 0 uses one per hardware thread
+*/
+BulkEvaluator::BulkEvaluator(unsigned int threadCount)
+{
+	if (threadCount == 0)
+	{
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		workers.push_back(std::make_unique<Worker>());
+	}
+
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		threads.emplace_back(&BulkEvaluator::run, this, i);
+	}
+}
+
+/*	Function:	Stop & join the worker threads
+*/
+BulkEvaluator::~BulkEvaluator()
+{
+	{
+		std::lock_guard<std::mutex> guard(jobLock);
+		stopping = true;
+	}
+
+	jobStarted.notify_all();
+
+	for (size_t i = 0; i < threads.size(); i++)
+	{
+		threads[i].join();
+	}
+}
+
+/*	Function:	- Evaluate every expression, blocking until all are done
+				- results[i] & statuses[i] receive the outcome of expressions[i]
+				- Must not be called concurrently on the same BulkEvaluator
+	Parameters:	1) string_view ptr expressions	- Expressions to evaluate
+				2) size_t count					- Number of expressions
+				3) int ptr results				- Output buffer for count results
+				4) EvaluationStatus ptr statuses	- Output buffer for count statuses
+	Returns:	void
+*/
+void BulkEvaluator::evaluateAll(const std::string_view* expressions, size_t count, int* results, EvaluationStatus* statuses)
+{
+	std::unique_lock<std::mutex> guard(jobLock);
+
+	// Split the input into one contiguous range per worker
+	const size_t workerCount = workers.size();
+
+	for (size_t i = 0; i < workerCount; i++)
+	{
+		std::lock_guard<std::mutex> rangeGuard(workers[i]->rangeLock);
+		workers[i]->next = count * i / workerCount;
+		workers[i]->end = count * (i + 1) / workerCount;
+	}
+
+	jobExpressions = expressions;
+	jobResults = results;
+	jobStatuses = statuses;
+	activeWorkers = static_cast<unsigned int>(workerCount);
+	jobGeneration++;
+
+	jobStarted.notify_all();
+	jobFinished.wait(guard, [this] { return activeWorkers == 0; });
+}
+
+/*	Function:	Claim the next chunk of a worker's own range
+	Parameters:	1) Worker ref worker	- Worker claiming work
+				2) size_t ref first		- Receives the first expression of the chunk
+				3) size_t ref last		- Receives one past the last expression of the chunk
+	Returns:	bool - False once the worker's range is empty
+*/
+bool BulkEvaluator::claimWork(Worker& worker, size_t& first, size_t& last)
+{
+	std::lock_guard<std::mutex> rangeGuard(worker.rangeLock);
+
+	if (worker.next >= worker.end)
+	{
+		return false;
+	}
+
+	first = worker.next;
+	last = std::min(worker.next + chunkSize, worker.end);
+	worker.next = last;
+	return true;
+}
+
+/*	Function:	Move the back half of another worker's remaining range to the thief
+	Parameters:	1) unsigned int thiefIndex	- Index of the idle worker
+	Returns:	bool - False if every other worker's range is empty
+*/
+bool BulkEvaluator::stealWork(unsigned int thiefIndex)
+{
+	const size_t workerCount = workers.size();
+
+	for (size_t offset = 1; offset < workerCount; offset++)
+	{
+		Worker& victim = *workers[(thiefIndex + offset) % workerCount];
+		size_t stolenFirst;
+		size_t stolenEnd;
+
+		{
+			std::lock_guard<std::mutex> rangeGuard(victim.rangeLock);
+
+			if (victim.next >= victim.end)
+			{
+				continue;
+			}
+
+			const size_t remaining = victim.end - victim.next;
+
+			// Small ranges are taken whole; larger ones are split in half
+			stolenFirst = remaining <= chunkSize ? victim.next : victim.next + remaining / 2;
+			stolenEnd = victim.end;
+			victim.end = stolenFirst;
+		}
+
+		Worker& thief = *workers[thiefIndex];
+		std::lock_guard<std::mutex> rangeGuard(thief.rangeLock);
+		thief.next = stolenFirst;
+		thief.end = stolenEnd;
+		return true;
+	}
+
+	return false;
+}
+
+/*	Function:	Worker thread loop; waits for jobs & evaluates claimed or stolen chunks
+	Parameters:	1) unsigned int index	- Index of the worker run by this thread
+	Returns:	void
+*/
+void BulkEvaluator::run(unsigned int index)
+{
+	Worker& worker = *workers[index];
+	unsigned long long seenGeneration = 0;
+
+	while (true)
+	{
+		const std::string_view* expressions;
+		int* results;
+		EvaluationStatus* statuses;
+
+		// Wait for a new job or shutdown
+		{
+			std::unique_lock<std::mutex> guard(jobLock);
+			jobStarted.wait(guard, [&] { return stopping || jobGeneration != seenGeneration; });
+
+			if (stopping)
+			{
+				return;
+			}
+
+			seenGeneration = jobGeneration;
+			expressions = jobExpressions;
+			results = jobResults;
+			statuses = jobStatuses;
+		}
+
+		// Work through our own range, then help others until nothing is left
+		size_t first;
+		size_t last;
+
+		do
+		{
+			while (claimWork(worker, first, last))
+			{
+				for (size_t i = first; i < last; i++)
+				{
+					statuses[i] = evaluate(expressions[i], worker.context, results[i]);
+				}
+			}
+		} while (stealWork(index));
+
+		// The last worker to finish releases the caller
+		std::lock_guard<std::mutex> guard(jobLock);
+
+		if (--activeWorkers == 0)
+		{
+			jobFinished.notify_all();
+		}
+	}
+}
+#pragma endregion
+
+#pragma region Streaming Evaluation
+/*	Class:		- Evaluates an expression delivered in chunks, e.g. read incrementally from a file
+				- Tokens are shunted as they are lexed & each postfix instruction is executed
+					as soon as the Shunting-Yard outputs it; neither the expression, its tokens
+					nor its program are ever held in full
+				- Memory is bounded by the operator & value stacks plus the longest token
+				- Supports constant expressions only; variables are reported as unbound
+				- Errors are reported in input order, so an evaluation error (e.g. division by zero)
+					may be reported before a syntax error later in the input
+*/
+class StreamingEvaluator
+{
+	public:
+		StreamingEvaluator() { reset(); }
+
+		// Discard any partially evaluated expression
+		void reset();
+
+		EvaluationStatus feed(std::string_view chunk);
+		EvaluationStatus finish(int& result);
+
+	private:
+		// Sink executing each emitted instruction immediately
+		struct ValueSink
+		{
+			StreamingEvaluator& evaluator;
+
+			EvaluationStatus emit(const Instruction& instruction, unsigned int offset);
+		};
+
+		EvaluationStatus processToken(Token token, std::string_view text);
+
+		ShuntingYard shunter;			// Incremental shunt state
+		std::vector<int> values;		// Value stack of the instructions executed so far
+		std::string partialText;		// Number or variable split across the end of the last chunk
+		Token partialToken;				// Kind & offset of the split token
+		size_t streamOffset;			// Offset of the next chunk in the whole stream
+		EvaluationStatus failure;		// First error seen; sticky until reset()
+		unsigned int secondValueOffset;	// Offset of the value second from the bottom, reported
+										//		if it is never combined (as verifyProgram does)
+		unsigned int unknownNameOffset;	// Offset of a name that is neither a function nor bindable,
+										//		held until the next token shows if it was called; or UINT_MAX
+};
+
+/*	Function:	Discard any partially evaluated expression
+	Returns:	void
+*/
+void StreamingEvaluator::reset()
+{
+	shunter.beginShunt();
+	values.clear();
+	partialText.clear();
+	partialToken = Token{ TokenKind::Invalid, 0, 0 };
+	streamOffset = 0;
+	failure = EvaluationStatus();
+	secondValueOffset = 0;
+	unknownNameOffset = UINT_MAX;
+}
+
+/*	Function:	Execute an instruction as soon as the shunt emits it
+	Parameters:	1) Instruction ref instruction	- Instruction to execute
+				2) unsigned int offset			- Stream offset of the token behind it
+	Returns:	EvaluationStatus - Whether or not the instruction executed successfully
+*/
+EvaluationStatus StreamingEvaluator::ValueSink::emit(const Instruction& instruction, unsigned int offset)
+{
+	EvaluationStatus status;
+	std::vector<int>& values = evaluator.values;
+
+	// Checks the stack as verifyProgram does, since the program is never held in full
+	const unsigned char arity = instructionArity(instruction);
+
+	if (values.size() < arity)
+	{
+		status.error = EvaluationError::NotEnoughArguments;
+		status.offset = offset;
+		return status;
+	}
+
+	switch (instruction.opCode)
+	{
+		case OpCode::PushConstant:
+			values.push_back(instruction.operand);
+			break;
+
+		case OpCode::Negate:
+			values.back() = negateValue(values.back(), 0);
+			break;
+
+		case OpCode::Absolute:
+			values.back() = absoluteValue(values.back(), 0);
+			break;
+
+		case OpCode::Call:
+			values.resize(values.size() - arity + 1);
+			status.error = invokeFunction(instruction.operand, values.data() + values.size() - 1);
+			break;
+
+		default:
+		{
+			const int rhs = values.back();
+			values.pop_back();
+			status.error = applyOperator(instruction.opCode, values.back(), rhs, values.back());
+			break;
+		}
+	}
+
+	// Calls without arguments push a value too
+	if (arity == 0 && values.size() == 2)
+	{
+		evaluator.secondValueOffset = offset;
+	}
+
+	status.offset = offset;
+	return status;
+}
+
+/*	Function:	Shunt one complete token
+	Parameters:	1) Token token		- Token with its offset in the whole stream
+				2) string_view text	- Characters of the token
+	Returns:	EvaluationStatus - Whether or not the token was processed successfully
+*/
+EvaluationStatus StreamingEvaluator::processToken(Token token, std::string_view text)
+{
+	EvaluationStatus status;
+
+	// An unknown name directly called is reported as the shunt would; anything else left it unbound
+	if (unknownNameOffset != UINT_MAX)
+	{
+		status.error = token.kind == TokenKind::LeftParenthesis
+			? EvaluationError::UnknownFunction : EvaluationError::UnboundVariable;
+		status.offset = unknownNameOffset;
+		return status;
+	}
+
+	// Variable names would have to outlive their chunk to be bound later
+	// Function names are resolved straight away, so they may go
+	if (token.kind == TokenKind::Variable && findFunction(text) == noFunction)
+	{
+		unknownNameOffset = token.offset;
+		return status;
+	}
+
+	ValueSink sink = { *this };
+	return shunter.shuntToken(token, text, sink);
+}
+
+/*	Function:	- Lex, shunt & execute the next chunk of the expression
+				- A number or variable running up to the end of the chunk is held back
+					until the next chunk shows whether it continues
+	Parameters:	1) string_view chunk	- Next characters of the expression; need not outlive the call
+	Returns:	EvaluationStatus - The first error met so far, if any
+*/
+EvaluationStatus StreamingEvaluator::feed(std::string_view chunk)
+{
+	if (!failure)
+	{
+		return failure;
+	}
+
+	const size_t chunkOffset = streamOffset;
+	streamOffset += chunk.size();
+	size_t position = 0;
+
+	// Reject the stream as soon as it passes the length limit, without lexing this chunk
+	const size_t maximumLength = shunter.limitsInForce().maximumLength;
+
+	if (streamOffset > maximumLength)
+	{
+		failure.error = EvaluationError::ExpressionTooLong;
+		failure.offset = static_cast<unsigned int>(std::min<size_t>(maximumLength, UINT_MAX));
+		return failure;
+	}
+
+	// Finish a token split across the previous chunk boundary
+	if (!partialText.empty())
+	{
+		const bool isNumber = partialToken.kind == TokenKind::Number;
+
+		while (position < chunk.size() &&
+			(isNumber ? isNumberCharacter(chunk[position]) : isIdentifierCharacter(chunk[position])))
+		{
+			position++;
+		}
+
+		partialText.append(chunk.data(), position);
+
+		// Still running off the end of this chunk too
+		if (position == chunk.size())
+		{
+			return failure;
+		}
+
+		partialToken.length = static_cast<unsigned int>(partialText.size());
+		failure = processToken(partialToken, partialText);
+		partialText.clear();
+
+		if (!failure)
+		{
+			return failure;
+		}
+	}
+
+	Lexer lexer(chunk.substr(position));
+	Token token;
+
+	while (lexer.next(token))
+	{
+		const std::string_view text = lexer.text(token);
+		const size_t localEnd = position + token.offset + token.length;
+
+		token.offset = static_cast<unsigned int>(chunkOffset + position + token.offset);
+
+		// Multi-character tokens touching the end of the chunk may continue in the next one
+		if (localEnd == chunk.size() && (token.kind == TokenKind::Number || token.kind == TokenKind::Variable))
+		{
+			partialToken = token;
+			partialText.assign(text.data(), text.size());
+			break;
+		}
+
+		failure = processToken(token, text);
+
+		if (!failure)
+		{
+			break;
+		}
+	}
+
+	return failure;
+}
+
+/*	Function:	- Complete the expression & fetch its result
+				- The evaluator is reset afterwards, ready for the next expression
+	Parameters:	1) int ref result	- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus StreamingEvaluator::finish(int& result)
+{
+	EvaluationStatus status = failure;
+	ValueSink sink = { *this };
+
+	// The last token may be waiting for a chunk that never came
+	if (status && !partialText.empty())
+	{
+		status = processToken(partialToken, partialText);
+	}
+
+	if (status && unknownNameOffset != UINT_MAX)
+	{
+		status.error = EvaluationError::UnboundVariable;
+		status.offset = unknownNameOffset;
+	}
+
+	if (status)
+	{
+		status = shunter.endShunt(sink);
+	}
+
+	if (status)
+	{
+		if (values.empty())
+		{
+			status.error = EvaluationError::EmptyExpression;
+		}
+
+		else if (values.size() > 1)
+		{
+			status.error = EvaluationError::MissingOperator;
+			status.offset = secondValueOffset;
+		}
+
+		else
+		{
+			result = values[0];
+		}
+	}
+
+	reset();
+	return status;
+}
+
+/*	Function:	Evaluate an expression read incrementally from a stream
+	Parameters:	1) istream ref input	- Stream holding the expression; read until end of file
+				2) int ref result		- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus evaluateStream(std::istream& input, int& result)
+{
+	StreamingEvaluator evaluator;
+	char buffer[65536];
+
+	while (input)
+	{
+		input.read(buffer, sizeof(buffer));
+
+		if (!evaluator.feed(std::string_view(buffer, static_cast<size_t>(input.gcount()))))
+		{
+			break;
+		}
+	}
+
+	return evaluator.finish(result);
+}
+#pragma endregion
+
+#pragma region Memory-Mapped Files
+/*	Class:		- A file mapped into memory, read-only or writable
+				- Uses mmap where available, so expressions are tokenised straight from the
+					page cache; elsewhere the file is read into (or written from) a buffer
+				- The mapping is released when the object is destroyed
+*/
+class MappedFile
+{
+	public:
+		MappedFile() = default;
+		~MappedFile() { close(); }
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool openForReading(const char* path);
+		bool createForWriting(const char* path, size_t size);
+		void close();
+
+		const char* data() const { return bytes; }
+		char* writableData() { return writable ? bytes : nullptr; }
+		size_t size() const { return length; }
+		std::string_view contents() const { return std::string_view(bytes, length); }
+
+	private:
+		char* bytes = nullptr;			// Start of the mapping
+		size_t length = 0;				// Size of the mapping in bytes
+		bool writable = false;			// Whether the mapping was created for output
+		std::string path;				// Output path, for the buffered fallback
+		std::vector<char> buffer;		// Backing store for the buffered fallback
+};
+
+/*	Function:	Map an existing file for reading
+	Parameters:	1) const char ptr filePath	- File to map
+	Returns:	bool - Whether or not the file could be mapped
+*/
+bool MappedFile::openForReading(const char* filePath)
+{
+	close();
+
+#ifdef SHUNTING_YARD_HAS_MMAP
+	const int descriptor = ::open(filePath, O_RDONLY);
+
+	if (descriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat information;
+
+	if (fstat(descriptor, &information) != 0)
+	{
+		::close(descriptor);
+		return false;
+	}
+
+	length = static_cast<size_t>(information.st_size);
+
+	// Empty files cannot be mapped, but are valid input
+	if (length > 0)
+	{
+		void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+		if (mapping == MAP_FAILED)
+		{
+			::close(descriptor);
+			length = 0;
+			return false;
+		}
+
+		// Expressions are read front to back exactly once
+		madvise(mapping, length, MADV_SEQUENTIAL);
+		bytes = static_cast<char*>(mapping);
+	}
+
+	::close(descriptor);
+	return true;
+#else
+	std::ifstream input(filePath, std::ios::binary);
+
+	if (!input)
+	{
+		return false;
+	}
+
+	buffer.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+	bytes = buffer.data();
+	length = buffer.size();
+	return true;
+#endif
+}
+
+/*	Function:	Create (or truncate) a file of the given size & map it for writing
+	Parameters:	1) const char ptr filePath	- File to create
+				2) size_t size			- Size of the file in bytes
+	Returns:	bool - Whether or not the file could be created & mapped
+*/
+bool MappedFile::createForWriting(const char* filePath, size_t size)
+{
+	close();
+	writable = true;
+
+#ifdef SHUNTING_YARD_HAS_MMAP
+	const int descriptor = ::open(filePath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+	if (descriptor < 0)
+	{
+		return false;
+	}
+
+	if (ftruncate(descriptor, static_cast<off_t>(size)) != 0)
+	{
+		::close(descriptor);
+		return false;
+	}
+
+	if (size > 0)
+	{
+		void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+
+		if (mapping == MAP_FAILED)
+		{
+			::close(descriptor);
+			return false;
+		}
+
+		bytes = static_cast<char*>(mapping);
+	}
+
+	length = size;
+	::close(descriptor);
+	return true;
+#else
+	path = filePath;
+	buffer.assign(size, 0);
+	bytes = buffer.data();
+	length = size;
+	return true;
+#endif
+}
+
+/*	Function:	Release the mapping, flushing writable files to disk
+	Returns:	void
+*/
+void MappedFile::close()
+{
+#ifdef SHUNTING_YARD_HAS_MMAP
+	if (bytes != nullptr)
+	{
+		munmap(bytes, length);
+	}
+#else
+	if (writable && !path.empty())
+	{
+		std::ofstream output(path, std::ios::binary);
+		output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	}
+
+	buffer.clear();
+	path.clear();
+#endif
+
+	bytes = nullptr;
+	length = 0;
+	writable = false;
+}
+
+/*	Struct:		- Outcome of evaluating one line of an expression file
+				- Plain data, so an array of them can be written straight to a mapped output file
+*/
+struct LineResult
+{
+	int result;					// Value of the expression; 0 if evaluation failed
+	EvaluationStatus status;	// Whether or not the expression evaluated, & if not why
+};
+
+/*	Function:	Count the newline-separated lines in a block of text
+	Parameters:	1) string_view text	- Text to count; a final line need not end in a newline
+	Returns:	size_t - Number of lines
+*/
+size_t countLines(std::string_view text)
+{
+	size_t lines = 0;
+	const char* position = text.data();
+	const char* end = text.data() + text.size();
+
+	while (position < end)
+	{
+		const void* newline = std::memchr(position, '\n', static_cast<size_t>(end - position));
+		position = newline != nullptr ? static_cast<const char*>(newline) + 1 : end;
+		lines++;
+	}
+
+	return lines;
+}
+
+/*	Function:	- Evaluate every newline-separated expression in a block of text
+				- Lines are viewed in place; nothing is copied before tokenising
+				- A carriage return before each newline is ignored
+	Parameters:	1) string_view text				- Expressions, one per line
+				2) LineResult ptr results		- Preallocated output, one entry per line
+				3) size_t capacity				- Number of entries results can hold
+				4) EvaluationContext ref context- Scratch buffers to evaluate with
+	Returns:	size_t - Number of lines evaluated; stops early if capacity is reached
+*/
+size_t evaluateLines(std::string_view text, LineResult* results, size_t capacity, EvaluationContext& context)
+{
+	size_t lines = 0;
+	size_t position = 0;
+
+	while (position < text.size() && lines < capacity)
+	{
+		const void* newline = std::memchr(text.data() + position, '\n', text.size() - position);
+		const size_t end = newline != nullptr ? static_cast<size_t>(static_cast<const char*>(newline) - text.data()) : text.size();
+		std::string_view line = text.substr(position, end - position);
+
+		if (!line.empty() && line.back() == '\r')
+		{
+			line.remove_suffix(1);
+		}
+
+		LineResult& entry = results[lines++];
+		entry.result = 0;
+		entry.status = evaluate(line, context, entry.result);
+
+		position = end + 1;
+	}
+
+	return lines;
+}
+
+/*	Function:	- Evaluate a file of newline-separated expressions into a mapped output file
+				- The output holds one LineResult per input line, in input order
+	Parameters:	1) const char ptr inputPath		- File of expressions to evaluate
+				2) const char ptr outputPath	- File to create for the results
+				3) size_t ref lineCount			- Receives the number of lines evaluated
+	Returns:	bool - Whether or not both files could be mapped
+*/
+bool evaluateFile(const char* inputPath, const char* outputPath, size_t& lineCount)
+{
+	MappedFile input;
+	MappedFile output;
+
+	lineCount = 0;
+
+	if (!input.openForReading(inputPath))
+	{
+		return false;
+	}
+
+	// Size the output up front so results are written straight into its pages
+	const size_t lines = countLines(input.contents());
+
+	if (!output.createForWriting(outputPath, lines * sizeof(LineResult)))
+	{
+		return false;
+	}
+
+	LineResult* results = reinterpret_cast<LineResult*>(output.writableData());
+	lineCount = evaluateLines(input.contents(), results, lines, threadContext());
+	return true;
+}
+#pragma endregion
+
+#pragma region Program Files
+/*	Struct:		- Fixed-size header at the start of a program file
+				- A program file holds many compiled programs, laid out so that a mapped
+					file can be evaluated in place: every section is an array of plain
+					structs at an 8-byte aligned offset, & instructions are stored exactly
+					as they are in memory
+				- Files are written & read in native byte order; byteOrder detects a file
+					written on a machine of the other endianness
+				- Sections, in file order:
+					ProgramRecord[programCount]			- One per program
+					Instruction[instructionCount]		- Every program's instructions, back to back
+					uint32_t[instructionCount]			- Source offset of each instruction
+					ProgramString[variableCount]		- Every program's variable names
+					char[stringBytes]					- Text of the variable names
+*/
+struct ProgramFileHeader
+{
+	char magic[8];					// programFileMagic
+	uint32_t version;				// programFileVersion; bumped whenever the layout or OpCode values change
+	uint32_t byteOrder;				// programFileByteOrder, as written by this machine
+	uint32_t instructionSize;		// sizeof(Instruction) of the writer
+	uint32_t programCount;			// Number of ProgramRecords
+	uint64_t instructionCount;		// Total instructions across all programs
+	uint64_t variableCount;			// Total variable names across all programs
+	uint64_t stringBytes;			// Size of the variable name text
+	uint64_t programsOffset;		// File offset of each section
+	uint64_t instructionsOffset;
+	uint64_t offsetsOffset;
+	uint64_t variablesOffset;
+	uint64_t stringsOffset;
+};
+
+// One compiled program within a program file
+struct ProgramRecord
+{
+	uint32_t firstInstruction;		// Index of the program's first instruction & source offset
+	uint32_t instructionCount;		// Number of instructions; 0 for programs that failed to compile
+	uint32_t firstVariable;			// Index of the program's first variable name
+	uint32_t variableCount;			// Number of variables the program reads
+	uint32_t stackDepth;			// Deepest value stack the program reaches
+	uint32_t valid;					// Non-zero if the expression compiled
+};
+
+// A variable name, as a range of the file's string section
+struct ProgramString
+{
+	uint32_t offset;				// Offset into the string section
+	uint32_t length;				// Length of the name in bytes
+};
+
+constexpr char programFileMagic[8] = { 'S', 'Y', 'P', 'R', 'O', 'G', '\r', '\n' };
+constexpr uint32_t programFileVersion = 1;
+constexpr uint32_t programFileByteOrder = 0x01020304;
+
+static_assert(std::is_trivially_copyable<Instruction>::value && std::is_trivially_copyable<ProgramRecord>::value,
+	"Program file sections are read in place");
+static_assert(sizeof(ProgramFileHeader) % 8 == 0 && alignof(Instruction) <= 8, "Program file sections are 8-byte aligned");
+
+// Round a section offset up to the next multiple of 8
+constexpr uint64_t alignSection(uint64_t offset) { return (offset + 7) & ~uint64_t(7); }
+
+/*	Function:	- Write compiled expressions to a program file, in the given order
+				- Expressions that failed to compile are kept, so indices still line up
+					with the caller's list, & evaluate with EvaluationError::NotCompiled
+				- Expressions calling registered functions cannot be saved; a Call holds a
+					registry index, which means nothing to another process
+	Parameters:	1) const char ptr path					- File to create
+				2) CompiledExpression ptr expressions	- Expressions to save
+				3) size_t count							- Number of expressions
+	Returns:	bool - Whether or not the file could be written
+*/
+bool saveProgramFile(const char* path, const CompiledExpression* expressions, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		for (const Instruction& instruction : expressions[i].program())
+		{
+			if (instruction.opCode == OpCode::Call)
+			{
+				return false;
+			}
+		}
+	}
+
+	ProgramFileHeader header = {};
+	std::memcpy(header.magic, programFileMagic, sizeof(header.magic));
+	header.version = programFileVersion;
+	header.byteOrder = programFileByteOrder;
+	header.instructionSize = sizeof(Instruction);
+	header.programCount = static_cast<uint32_t>(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		header.instructionCount += expressions[i].program().size();
+		header.variableCount += expressions[i].variables().size();
+
+		for (size_t j = 0; j < expressions[i].variables().size(); j++)
+		{
+			header.stringBytes += expressions[i].variables()[j].size();
+		}
+	}
+
+	// Records index instructions & strings with 32 bits
+	if (count > UINT32_MAX || header.instructionCount > UINT32_MAX || header.variableCount > UINT32_MAX
+		|| header.stringBytes > UINT32_MAX)
+	{
+		return false;
+	}
+
+	header.programsOffset = alignSection(sizeof(ProgramFileHeader));
+	header.instructionsOffset = alignSection(header.programsOffset + count * sizeof(ProgramRecord));
+	header.offsetsOffset = alignSection(header.instructionsOffset + header.instructionCount * sizeof(Instruction));
+	header.variablesOffset = alignSection(header.offsetsOffset + header.instructionCount * sizeof(uint32_t));
+	header.stringsOffset = alignSection(header.variablesOffset + header.variableCount * sizeof(ProgramString));
+
+	MappedFile output;
+
+	if (!output.createForWriting(path, static_cast<size_t>(header.stringsOffset + header.stringBytes)))
+	{
+		return false;
+	}
+
+	// The new file is zero-filled, so padding between & within records stays zero
+	char* bytes = output.writableData();
+	std::memcpy(bytes, &header, sizeof(header));
+
+	ProgramRecord* records = reinterpret_cast<ProgramRecord*>(bytes + header.programsOffset);
+	Instruction* instructions = reinterpret_cast<Instruction*>(bytes + header.instructionsOffset);
+	uint32_t* offsets = reinterpret_cast<uint32_t*>(bytes + header.offsetsOffset);
+	ProgramString* variables = reinterpret_cast<ProgramString*>(bytes + header.variablesOffset);
+	char* strings = bytes + header.stringsOffset;
+
+	uint32_t instructionIndex = 0;
+	uint32_t variableIndex = 0;
+	uint32_t stringOffset = 0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const CompiledExpression& expression = expressions[i];
+		ProgramRecord& record = records[i];
+
+		record.firstInstruction = instructionIndex;
+		record.instructionCount = static_cast<uint32_t>(expression.program().size());
+		record.firstVariable = variableIndex;
+		record.variableCount = static_cast<uint32_t>(expression.variables().size());
+		record.stackDepth = static_cast<uint32_t>(expression.stackDepth());
+		record.valid = expression.isValid() ? 1 : 0;
+
+		for (size_t j = 0; j < expression.program().size(); j++, instructionIndex++)
+		{
+			instructions[instructionIndex].opCode = expression.program()[j].opCode;
+			instructions[instructionIndex].operand = expression.program()[j].operand;
+			offsets[instructionIndex] = expression.offsets()[j];
+		}
+
+		for (size_t j = 0; j < expression.variables().size(); j++, variableIndex++)
+		{
+			const std::string& name = expression.variables()[j];
+			variables[variableIndex].offset = stringOffset;
+			variables[variableIndex].length = static_cast<uint32_t>(name.size());
+			std::memcpy(strings + stringOffset, name.data(), name.size());
+			stringOffset += static_cast<uint32_t>(name.size());
+		}
+	}
+
+	return true;
+}
+
+/*	Class:		- Read-only view of a program file, evaluated in place
+				- Opening maps the file & validates it in one pass over its sections,
+					without copying or allocating; no expression is reparsed
+				- Every program is re-verified on open, so a corrupt or hand-edited file
+					is rejected rather than run by the unchecked interpreter
+				- Immutable once open, so it may be evaluated by many threads at once
+*/
+class ProgramFile
+{
+	public:
+		bool open(const char* path);
+		void close() { file.close(); header = nullptr; }
+
+		// Whether a file is open
+		bool isOpen() const { return header != nullptr; }
+
+		// Number of programs in the file
+		size_t size() const { return header != nullptr ? header->programCount : 0; }
+
+		// Whether program index compiled successfully
+		bool isValid(size_t index) const { return records[index].valid != 0; }
+
+		// Instructions of program index, in place in the mapping
+		const Instruction* program(size_t index) const { return instructions + records[index].firstInstruction; }
+		size_t programSize(size_t index) const { return records[index].instructionCount; }
+
+		// Source offset of each of program index's instructions
+		const uint32_t* offsets(size_t index) const { return sourceOffsets + records[index].firstInstruction; }
+
+		// Variables read by program index; values are supplied in this order
+		size_t variableCount(size_t index) const { return records[index].variableCount; }
+
+		std::string_view variable(size_t index, size_t variable) const
+		{
+			const ProgramString& name = variables[records[index].firstVariable + variable];
+			return std::string_view(strings + name.offset, name.length);
+		}
+
+		// Deepest value stack program index reaches
+		size_t stackDepth(size_t index) const { return records[index].stackDepth; }
+
+	private:
+		MappedFile file;									// Mapping of the whole file
+		const ProgramFileHeader* header = nullptr;			// Start of the mapping, once validated
+		const ProgramRecord* records = nullptr;				// Sections, in place
+		const Instruction* instructions = nullptr;
+		const uint32_t* sourceOffsets = nullptr;
+		const ProgramString* variables = nullptr;
+		const char* strings = nullptr;
+};
+
+/*	Function:	- Map a program file & check that every program in it can be run unchecked
+				- Checks the header, that each section lies within the file, & that every
+					program references only its own instructions, variables & strings
+				- Each program is then verified as shunted programs are: known operators,
+					variables in range, & a stack depth that never underflows
+	Parameters:	1) const char ptr path	- File written by saveProgramFile
+	Returns:	bool - Whether or not the file could be mapped & is valid
+*/
+bool ProgramFile::open(const char* path)
+{
+	close();
+
+	if (!file.openForReading(path) || file.size() < sizeof(ProgramFileHeader))
+	{
+		file.close();
+		return false;
+	}
+
+	const char* bytes = file.data();
+	const ProgramFileHeader& candidate = *reinterpret_cast<const ProgramFileHeader*>(bytes);
+	const uint64_t fileSize = file.size();
+
+	// A section fits if it starts aligned & ends within the file
+	auto sectionFits = [fileSize](uint64_t offset, uint64_t count, uint64_t elementSize)
+	{
+		return offset % 8 == 0 && offset <= fileSize && count <= (fileSize - offset) / elementSize;
+	};
+
+	if (std::memcmp(candidate.magic, programFileMagic, sizeof(candidate.magic)) != 0
+		|| candidate.version != programFileVersion
+		|| candidate.byteOrder != programFileByteOrder
+		|| candidate.instructionSize != sizeof(Instruction)
+		|| !sectionFits(candidate.programsOffset, candidate.programCount, sizeof(ProgramRecord))
+		|| !sectionFits(candidate.instructionsOffset, candidate.instructionCount, sizeof(Instruction))
+		|| !sectionFits(candidate.offsetsOffset, candidate.instructionCount, sizeof(uint32_t))
+		|| !sectionFits(candidate.variablesOffset, candidate.variableCount, sizeof(ProgramString))
+		|| !sectionFits(candidate.stringsOffset, candidate.stringBytes, 1))
+	{
+		file.close();
+		return false;
+	}
+
+	const ProgramRecord* candidateRecords = reinterpret_cast<const ProgramRecord*>(bytes + candidate.programsOffset);
+	const Instruction* candidateInstructions = reinterpret_cast<const Instruction*>(bytes + candidate.instructionsOffset);
+	const ProgramString* candidateVariables = reinterpret_cast<const ProgramString*>(bytes + candidate.variablesOffset);
+
+	for (uint32_t i = 0; i < candidate.programCount; i++)
+	{
+		const ProgramRecord& record = candidateRecords[i];
+		bool valid = uint64_t(record.firstInstruction) + record.instructionCount <= candidate.instructionCount
+			&& uint64_t(record.firstVariable) + record.variableCount <= candidate.variableCount
+			&& (record.valid == 0 || record.instructionCount > 0);
+
+		for (uint32_t j = 0; valid && j < record.variableCount; j++)
+		{
+			const ProgramString& name = candidateVariables[record.firstVariable + j];
+			valid = uint64_t(name.offset) + name.length <= candidate.stringBytes;
+		}
+
+		// Only push, variable & operator instructions may appear in an int program; never a Call
+		const Instruction* program = candidateInstructions + record.firstInstruction;
+
+		for (uint32_t j = 0; valid && j < record.instructionCount; j++)
+		{
+			const OpCode opCode = program[j].opCode;
+
+			valid = opCode == OpCode::PushConstant
+				|| (opCode == OpCode::PushVariable && program[j].operand >= 0
+					&& static_cast<uint32_t>(program[j].operand) < record.variableCount)
+				|| (opCode >= OpCode::Add && opCode <= OpCode::Absolute);
+		}
+
+		if (valid && record.valid != 0)
+		{
+			valid = static_cast<bool>(verifyProgram(program, record.instructionCount))
+				&& measureStackDepth(program, record.instructionCount) <= record.stackDepth;
+		}
+
+		if (!valid)
+		{
+			file.close();
+			return false;
+		}
+	}
+
+	header = &candidate;
+	records = candidateRecords;
+	instructions = candidateInstructions;
+	sourceOffsets = reinterpret_cast<const uint32_t*>(bytes + candidate.offsetsOffset);
+	variables = candidateVariables;
+	strings = bytes + candidate.stringsOffset;
+	return true;
+}
+
+/*	Function:	- Evaluates one program of a program file, straight from the mapping
+				- Runs on the interpreter; no tokenising, shunting or copying
+	Parameters:	1) ProgramFile ref file				- Reference to the open program file
+				2) size_t index						- Index of the program to run
+				3) int ptr variables				- Value of each variable, in file.variable() order
+													- May be null for programs without variables
+				4) EvaluationContext ref context	- Reference to the scratch buffers to use
+				5) Int ref result					- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus evaluate(const ProgramFile& file, size_t index, const int* variables, EvaluationContext& context, int& result)
+{
+	EvaluationStatus status;
+
+	if (index >= file.size() || !file.isValid(index))
+	{
+		status.error = EvaluationError::NotCompiled;
+		return status;
+	}
+
+	status = context.rpn.calculatePostfix(file.program(index), file.programSize(index), result, variables);
+
+	// Report evaluation errors against the token that caused them
+	if (!status && status.offset < file.programSize(index))
+	{
+		status.offset = file.offsets(index)[status.offset];
+	}
+
+	return status;
+}
+
+/*	Function:	Evaluates one program of a program file using the calling thread's scratch
+	Parameters:	1) ProgramFile ref file				- Reference to the open program file
+				2) size_t index						- Index of the program to run
+				3) int ptr variables				- Value of each variable, in file.variable() order
+				4) Int ref result					- Reference to the variable for storing results
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus evaluate(const ProgramFile& file, size_t index, const int* variables, int& result)
+{
+	return evaluate(file, index, variables, threadContext(), result);
+}
+#pragma endregion
+
+#pragma region Asynchronous Evaluation
+#ifdef SHUNTING_YARD_HAS_COROUTINES
+/*	Class:		- Evaluates many compiled expressions whose variables live in a slow store
+				- Each evaluation is a coroutine that suspends until its variables are resolved;
+					the names every suspended evaluation waits on are gathered into one batch,
+					so a single round trip to the store serves all of them
+				- A name is requested once however many evaluations use it, & variables an
+					optimised program no longer reads are never requested
+				- The caller owns the I/O:
+					while (evaluator.run())
+					{
+						fetch evaluator.pendingNames() from the store;
+						evaluator.resolve(values, found);
+					}
+				- Resolved values are kept until every submitted evaluation has finished
+*/
+class AsyncEvaluator
+{
+	public:
+		AsyncEvaluator() = default;
+		~AsyncEvaluator();
+
+		AsyncEvaluator(const AsyncEvaluator&) = delete;
+		AsyncEvaluator& operator=(const AsyncEvaluator&) = delete;
+
+		void submit(const CompiledExpression& compiled, int& result, EvaluationStatus& status);
+
+		bool run();
+
+		// Names the suspended evaluations wait on, in the order resolve() expects their values
+		const std::vector<std::string_view>& pendingNames() const { return pending; }
+
+		void resolve(const int* values, const bool* found = nullptr);
+
+		// Number of batches resolved since construction
+		size_t fetchCount() const { return batches; }
+
+	private:
+		// Coroutine handle owner; evaluations start suspended & are resumed by run()
+		struct Task
+		{
+			struct promise_type
+			{
+				Task get_return_object() { return { std::coroutine_handle<promise_type>::from_promise(*this) }; }
+				std::suspend_always initial_suspend() noexcept { return {}; }
+				std::suspend_always final_suspend() noexcept { return {}; }
+				void return_void() {}
+				void unhandled_exception() { std::terminate(); }
+			};
+
+			std::coroutine_handle<promise_type> handle;
+		};
+
+		// Resolution of one variable name
+		struct Variable
+		{
+			int value = 0;
+			bool resolved = false;		// A batch holding the name has been resolved
+			bool found = false;			// The store had a value for it
+		};
+
+		// Awaitable suspending an evaluation until all of its variables are resolved
+		struct VariableRequest
+		{
+			AsyncEvaluator& evaluator;
+			const std::vector<Variable*>& variables;
+
+			bool await_ready() const;
+			void await_suspend(std::coroutine_handle<> handle) { evaluator.waiting.push_back(handle); }
+			void await_resume() const {}
+		};
+
+		Task evaluateTask(const CompiledExpression& compiled, int& result, EvaluationStatus& status);
+
+		std::unordered_map<std::string, Variable> known;	// Every name requested since the evaluator was idle
+		std::vector<std::string_view> pending;				// Names of the next batch; keys of known
+		std::vector<Variable*> pendingVariables;			// Entries of known for pending, in order
+		std::vector<std::coroutine_handle<>> ready;			// Evaluations that can make progress
+		std::vector<std::coroutine_handle<>> waiting;		// Evaluations suspended on the next batch
+		size_t outstanding = 0;								// Evaluations submitted but not finished
+		size_t batches = 0;
+};
+
+/*	Function:	Destroy any evaluations that never finished
+	Returns:	void
+*/
+AsyncEvaluator::~AsyncEvaluator()
+{
+	for (std::coroutine_handle<> handle : ready)
+	{
+		handle.destroy();
+	}
+
+	for (std::coroutine_handle<> handle : waiting)
+	{
+		handle.destroy();
+	}
+}
+
+/*	Function:	- Queue a compiled expression for evaluation; nothing runs until run()
+				- compiled, result & status must stay alive until run() returns false
+	Parameters:	1) CompiledExpression ref compiled	- Reference to the compiled program to run
+				2) Int ref result					- Receives the result once evaluated
+				3) EvaluationStatus ref status		- Receives whether or not the evaluation succeeded
+	Returns:	void
+*/
+void AsyncEvaluator::submit(const CompiledExpression& compiled, int& result, EvaluationStatus& status)
+{
+	ready.push_back(evaluateTask(compiled, result, status).handle);
+	outstanding++;
+}
+
+/*	Function:	- Resume every evaluation that can make progress, until each has either
+					finished or suspended on the next batch
+	Returns:	bool - Whether evaluations are waiting on pendingNames(); false once all have finished
+*/
+bool AsyncEvaluator::run()
+{
+	while (!ready.empty())
+	{
+		const std::coroutine_handle<> handle = ready.back();
+		ready.pop_back();
+		handle.resume();
+
+		if (handle.done())
+		{
+			handle.destroy();
+			outstanding--;
+		}
+	}
+
+	// Fetched values only stay valid while the evaluations that asked for them run
+	if (outstanding == 0)
+	{
+		known.clear();
+	}
+
+	return !waiting.empty();
+}
+
+/*	Function:	- Supply the values of pendingNames() & wake the evaluations waiting on them
+				- Evaluations using a name that was not found fail with UnboundVariable
+	Parameters:	1) int ptr values	- Value of each pending name, in pendingNames() order
+				2) bool ptr found	- Whether each pending name was found; null if all were
+	Returns:	void
+*/
+void AsyncEvaluator::resolve(const int* values, const bool* found)
+{
+	for (size_t i = 0; i < pendingVariables.size(); i++)
+	{
+		pendingVariables[i]->value = values[i];
+		pendingVariables[i]->found = found == nullptr || found[i];
+		pendingVariables[i]->resolved = true;
+	}
+
+	pending.clear();
+	pendingVariables.clear();
+	ready.insert(ready.end(), waiting.begin(), waiting.end());
+	waiting.clear();
+	batches++;
+}
+
+/*	Function:	Check whether an evaluation's variables have all been resolved already
+	Returns:	bool - True if the evaluation need not suspend
+*/
+bool AsyncEvaluator::VariableRequest::await_ready() const
+{
+	bool resolved = true;
+
+	for (Variable* variable : variables)
+	{
+		resolved = resolved && variable->resolved;
+	}
+
+	return resolved;
+}
+
+/*	Function:	- Coroutine evaluating one compiled expression
+				- Requests all of the program's variables before suspending once: with no
+					conditional operators, a valid program reads every one of them
+	Parameters:	1) CompiledExpression ref compiled	- Reference to the compiled program to run
+				2) Int ref result					- Receives the result
+				3) EvaluationStatus ref status		- Receives whether or not the evaluation succeeded
+	Returns:	Task - The suspended coroutine
+*/
+AsyncEvaluator::Task AsyncEvaluator::evaluateTask(const CompiledExpression& compiled, int& result, EvaluationStatus& status)
+{
+	const std::vector<Instruction>& program = compiled.program();
+	const std::vector<std::string>& names = compiled.variables();
+	std::vector<Variable*> used(names.size(), nullptr);
+	std::vector<Variable*> variables;
+	std::vector<int> values(names.size(), 0);
+
+	if (!compiled.isValid())
+	{
+		status = EvaluationStatus();
+		status.error = EvaluationError::NotCompiled;
+		co_return;
+	}
+
+	// Only names the program still reads; optimisation may have dropped some
+	for (const Instruction& instruction : program)
+	{
+		if (instruction.opCode == OpCode::PushVariable && used[instruction.operand] == nullptr)
+		{
+			auto entry = known.try_emplace(names[instruction.operand]);
+			used[instruction.operand] = &entry.first->second;
+			variables.push_back(&entry.first->second);
+
+			// New names join the next batch
+			if (entry.second)
+			{
+				pending.push_back(entry.first->first);
+				pendingVariables.push_back(&entry.first->second);
+			}
+		}
+	}
+
+	co_await VariableRequest{ *this, variables };
+
+	for (size_t i = 0; i < program.size(); i++)
+	{
+		if (program[i].opCode != OpCode::PushVariable)
+		{
+			continue;
+		}
+
+		const Variable& variable = *used[program[i].operand];
+
+		if (!variable.found)
+		{
+			status = EvaluationStatus();
+			status.error = EvaluationError::UnboundVariable;
+			status.offset = compiled.offsets()[i];
+			co_return;
+		}
+
+		values[program[i].operand] = variable.value;
+	}
+
+	status = evaluate(compiled, values.data(), result);
+}
+#endif
+#pragma endregion
+
+/*	Function:	- Evaluates a string-based mathematical expression
+				- Compiles the expression (tokenise & shunt)
+				- Calculates postfix expression
+				- Provides results, and notifies if calculation (un)successful
+				- Callers evaluating the same expression repeatedly should use
+					compile() once & evaluate(CompiledExpression) thereafter
+				- Reentrant; uses the calling thread's scratch context
+
+	Parameters:	1) String ref expression	- Reference to the string defining the expression
+				2) Int ref result			- Reference to the variable for storing results
+											- Pass-by-reference used to directly modify the
+												result value to be displayed withotu having to return
+												a value & allows the method to return true/false for
+												a successfuly calculation
+
+	Returns:	EvaluationStatus - Whether or not the evaluation was successful
+*/
+EvaluationStatus evaluate(const std::string& expression, int &result)
+{
+	// Tokenise, shunt & calculate using this thread's scratch buffers
+	return evaluate(std::string_view(expression), threadContext(), result);
+}
+
+#if !defined(SHUNTING_YARD_BENCHMARK) && !defined(SHUNTING_YARD_FUZZ)
+#pragma region Command-Line Driver
+/*	Command-line driver
+	- Evaluates newline-separated expressions from a file or stdin, one result per line
+		in input order, so it can sit in a pipeline or be run over production expression dumps
+	- Input is read a batch of lines at a time: a file is memory-mapped & lines are viewed
+		in place, stdin is read in large blocks, so memory is bounded by the batch size
+	- Each batch is evaluated on the calling thread, or across a BulkEvaluator pool when
+		more than one thread is asked for
+	- See printUsage() for the options
+*/
+
+// Block size read from stdin at a time
+const size_t driverReadSize = 1 << 16;
+
+/*	Enum:		How the driver writes its results
+*/
+enum class DriverOutput
+{
+	Text,		// One line per expression: the result, or "error: <description> at offset <n>"
+	Binary,		// One LineResult per expression, in native byte order, as evaluateFile() writes them
+	None		// Nothing; for measuring throughput
+};
+
+/*	Struct:		Options parsed from the command line
+*/
+struct DriverOptions
+{
+	const char* inputPath = nullptr;			// File of expressions; null or "-" reads stdin
+	unsigned int threadCount = 1;				// Worker threads; 0 uses one per hardware thread
+	size_t batchSize = 65536;					// Lines read & evaluated at a time
+	DriverOutput output = DriverOutput::Text;
+	bool printStats = false;					// Print throughput & per-stage timing to stderr
+	bool showHelp = false;
+	bool selfTest = false;						// Check the driver against knownDriverLines instead
+	EvaluationLimits limits;					// Applied to every expression
+};
+
+/*	Function:	Print the driver's usage
+	Parameters:	1) FILE ptr stream	- Stream to print to
+	Returns:	void
+*/
+void printUsage(FILE* stream)
+{
+	std::fprintf(stream,
+		"Usage: ShuntingYardSample [options] [file]\n"
+		"Evaluates one expression per line of file, or of stdin if no file (or -) is given.\n"
+		"\n"
+		"  -t, --threads N       Worker threads; 0 uses one per hardware thread (default 1)\n"
+		"  -b, --batch N         Lines read & evaluated at a time (default 65536)\n"
+		"  -o, --output FORMAT   text, binary (LineResult records) or none (default text)\n"
+		"  -s, --stats           Print throughput & per-stage timing to stderr\n"
+		"      --max-length N    Reject expressions longer than N characters\n"
+		"      --max-tokens N    Reject expressions of more than N tokens\n"
+		"      --max-depth N     Reject expressions nesting more than N operators & brackets\n"
+		"      --self-test       Check the driver's output for known lines & exit\n"
+		"  -h, --help            Print this message\n");
+}
+
+/*	Function:	Parse a whole, non-negative number given as an option's value
+	Parameters:	1) const char ptr text	- Option value; may be null if the value is missing
+				2) size_t ref value		- Receives the number
+	Returns:	bool - Whether or not text was a number
+*/
+bool parseCount(const char* text, size_t& value)
+{
+	if (text == nullptr || *text == '\0' || *text == '-')
+	{
+		return false;
+	}
+
+	char* end = nullptr;
+	const unsigned long long parsed = std::strtoull(text, &end, 10);
+	value = static_cast<size_t>(parsed);
+	return *end == '\0';
+}
+
+/*	Function:	Parse the command line into options
+	Parameters:	1) int argc					- Number of arguments
+				2) char ptr ptr argv		- Arguments, argv[0] being the program
+				3) DriverOptions ref options- Reference to the options to fill in
+	Returns:	bool - Whether or not every argument was understood; errors are printed to stderr
+*/
+bool parseDriverOptions(int argc, char** argv, DriverOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string_view argument = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		size_t count = 0;
+
+		// Options taking a value consume the next argument
+		if (argument == "-t" || argument == "--threads")
+		{
+			if (!parseCount(value, count) || count > UINT_MAX)
+			{
+				std::fprintf(stderr, "Invalid thread count\n");
+				return false;
+			}
+
+			options.threadCount = static_cast<unsigned int>(count);
+			i++;
+		}
+
+		else if (argument == "-b" || argument == "--batch")
+		{
+			if (!parseCount(value, count) || count == 0)
+			{
+				std::fprintf(stderr, "Invalid batch size\n");
+				return false;
+			}
+
+			options.batchSize = count;
+			i++;
+		}
+
+		else if (argument == "-o" || argument == "--output")
+		{
+			const std::string_view format = value != nullptr ? value : "";
+
+			if (format == "text")
+			{
+				options.output = DriverOutput::Text;
+			}
+
+			else if (format == "binary")
+			{
+				options.output = DriverOutput::Binary;
+			}
+
+			else if (format == "none")
+			{
+				options.output = DriverOutput::None;
+			}
+
+			else
+			{
+				std::fprintf(stderr, "Invalid output format\n");
+				return false;
+			}
+
+			i++;
+		}
+
+		else if (argument == "--max-length" || argument == "--max-tokens" || argument == "--max-depth")
+		{
+			if (!parseCount(value, count))
+			{
+				std::fprintf(stderr, "Invalid limit for %s\n", argv[i]);
+				return false;
+			}
+
+			size_t& limit = argument == "--max-length" ? options.limits.maximumLength :
+				argument == "--max-tokens" ? options.limits.maximumTokens : options.limits.maximumDepth;
+			limit = count;
+			i++;
+		}
+
+		else if (argument == "-s" || argument == "--stats")
+		{
+			options.printStats = true;
+		}
+
+		else if (argument == "-h" || argument == "--help")
+		{
+			options.showHelp = true;
+		}
+
+		else if (argument == "--self-test")
+		{
+			options.selfTest = true;
+		}
+
+		// A lone - is stdin; anything else starting with - is an unknown option
+		else if (argument.size() > 1 && argument[0] == '-')
+		{
+			std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+			return false;
+		}
+
+		else if (options.inputPath == nullptr)
+		{
+			options.inputPath = argv[i];
+		}
+
+		else
+		{
+			std::fprintf(stderr, "Only one input file may be given\n");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*	Class:		- Reads newline-separated lines a batch at a time
+				- Files are memory-mapped & viewed in place; stdin is read in driverReadSize
+					blocks into a buffer holding the current batch & any partial line after it
+				- A carriage return before each newline is ignored, as in evaluateLines()
+*/
+class LineReader
+{
+	public:
+		bool open(const char* path);
+
+		// Fill lines with views of up to count lines; views stay valid until the next call
+		// Returns false once the input is exhausted or fails to read
+		bool readBatch(size_t count, std::vector<std::string_view>& lines);
+
+		// Bytes handed out as lines so far, newlines included
+		size_t bytesRead() const { return consumedBytes; }
+
+		// Whether reading stopped because of an error rather than the end of the input
+		bool failed() const { return readError; }
+
+	private:
+		MappedFile mapping;				// Mapped input file, when reading a file
+		std::string_view remaining;		// Unread part of the mapping
+		FILE* stream = nullptr;			// stdin, when not reading a file
+		std::string buffer;				// Blocks read from stream, from the first unread line on
+		size_t bufferStart = 0;			// Start of the first unread line in buffer
+		size_t consumedBytes = 0;
+		bool atEnd = false;				// Whether stream has no more to read
+		bool readError = false;
+};
+
+/*	Function:	Open the input
+	Parameters:	1) const char ptr path	- File to map; null or "-" reads stdin
+	Returns:	bool - Whether or not the input could be opened
+*/
+bool LineReader::open(const char* path)
+{
+	if (path == nullptr || std::strcmp(path, "-") == 0)
+	{
+		stream = stdin;
+		return true;
+	}
+
+	if (!mapping.openForReading(path))
+	{
+		return false;
+	}
+
+	remaining = mapping.contents();
+	atEnd = true;
+	return true;
+}
+
+/*	Function:	- Split the next lines out of the input
+				- From stdin, blocks are read until count whole lines are buffered or the
+					input ends; a final line need not end in a newline
+	Parameters:	1) size_t count						- Most lines to return
+				2) Vector<string_view> ref lines	- Reference to the collection receiving the lines
+	Returns:	bool - Whether or not any lines were returned
+*/
+bool LineReader::readBatch(size_t count, std::vector<std::string_view>& lines)
+{
+	lines.clear();
+
+	if (stream != nullptr)
+	{
+		// The last batch's lines are no longer in use; keep only the partial line after them
+		buffer.erase(0, bufferStart);
+		bufferStart = 0;
+
+		size_t newlines = static_cast<size_t>(std::count(buffer.begin(), buffer.end(), '\n'));
+
+		while (newlines < count && !atEnd)
+		{
+			const size_t previousSize = buffer.size();
+			buffer.resize(previousSize + driverReadSize);
+
+			const size_t bytes = std::fread(&buffer[previousSize], 1, driverReadSize, stream);
+			buffer.resize(previousSize + bytes);
+			newlines += static_cast<size_t>(std::count(buffer.begin() + previousSize, buffer.end(), '\n'));
+
+			if (bytes < driverReadSize)
+			{
+				atEnd = true;
+				readError = std::ferror(stream) != 0;
+			}
+		}
+
+		remaining = std::string_view(buffer);
+	}
+
+	size_t position = 0;
+
+	while (lines.size() < count && position < remaining.size())
+	{
+		const void* newline = std::memchr(remaining.data() + position, '\n', remaining.size() - position);
+
+		// A partial line waits for the rest of it to be read
+		if (newline == nullptr && !atEnd)
+		{
+			break;
+		}
+
+		const size_t end = newline != nullptr ? static_cast<size_t>(static_cast<const char*>(newline) - remaining.data()) : remaining.size();
+		std::string_view line = remaining.substr(position, end - position);
+
+		if (!line.empty() && line.back() == '\r')
+		{
+			line.remove_suffix(1);
+		}
+
+		lines.push_back(line);
+		position = std::min(end + 1, remaining.size());
+	}
+
+	consumedBytes += position;
+
+	if (stream != nullptr)
+	{
+		bufferStart = position;
+	}
+
+	else
+	{
+		remaining.remove_prefix(position);
+	}
+
+	return !lines.empty();
+}
+
+/*	Function:	Append one text result line to the output buffer
+	Parameters:	1) int result				- Value of the expression
+				2) EvaluationStatus status	- Whether or not the expression evaluated
+				3) string ref output		- Reference to the buffer receiving the line
+	Returns:	void
+*/
+void appendTextResult(int result, EvaluationStatus status, std::string& output)
+{
+	char digits[16];
+
+	if (status)
+	{
+		const std::to_chars_result written = std::to_chars(digits, digits + sizeof(digits), result);
+		output.append(digits, written.ptr);
+	}
+
+	else
+	{
+		const std::to_chars_result written = std::to_chars(digits, digits + sizeof(digits), status.offset);
+		output += "error: ";
+		output += describeError(status.error);
+		output += " at offset ";
+		output.append(digits, written.ptr);
+	}
+
+	output += '\n';
+}
+
+/*	Function:	Print throughput, the driver's own stages & the instrumentation counters to stderr
+	Parameters:	1) size_t lines					- Expressions evaluated
+				2) size_t bytes					- Bytes of input read
+				3) size_t failures				- Expressions that failed to evaluate
+				4) double ptr stageSeconds		- Wall time reading, evaluating & writing
+				5) EvaluationStats ref stats	- Counters summed over every context used
+	Returns:	void
+*/
+void printDriverStats(size_t lines, size_t bytes, size_t failures, const double* stageSeconds, const EvaluationStats& stats)
+{
+	const double totalSeconds = stageSeconds[0] + stageSeconds[1] + stageSeconds[2];
+	const double perSecond = totalSeconds > 0.0 ? 1.0 / totalSeconds : 0.0;
+
+	std::fprintf(stderr, "Expressions: %zu (%zu failed) in %.3fs: %.3e expressions/s, %.1f MB/s\n",
+		lines, failures, totalSeconds, lines * perSecond, bytes * perSecond / 1e6);
+	std::fprintf(stderr, "Stages: read %.3fs, evaluate %.3fs, write %.3fs\n",
+		stageSeconds[0], stageSeconds[1], stageSeconds[2]);
+
+#ifdef SHUNTING_YARD_STATS
+	const double perExpression = lines > 0 ? 1.0 / lines : 0.0;
+
+	// Summed over every thread, so these are CPU time rather than wall time
+	std::fprintf(stderr, "Evaluation: %llu tokens, parse %.1f ns/expression, calculate %.1f ns/expression, "
+		"%.2f ns/token, deepest operator stack %zu, deepest value stack %zu, %llu buffer growths\n",
+		stats.tokens, stats.parseNanoseconds * perExpression, stats.calculateNanoseconds * perExpression,
+		stats.tokens > 0 ? static_cast<double>(stats.parseNanoseconds + stats.calculateNanoseconds) / stats.tokens : 0.0,
+		stats.maximumOperatorDepth, stats.maximumValueDepth, stats.bufferGrowths);
+
+	for (size_t i = 1; i < evaluationErrorCount; i++)
+	{
+		if (stats.failures[i] != 0)
+		{
+			std::fprintf(stderr, "Failures: %s %llu\n", describeError(static_cast<EvaluationError>(i)), stats.failures[i]);
+		}
+	}
+#else
+	(void)stats;
+	std::fprintf(stderr, "Parse & calculate timing needs a build with SHUNTING_YARD_STATS defined\n");
+#endif
+}
+
+/*	Function:	- Evaluate one batch of lines, in place or across the pool
+				- Each line gets its own status, so a failing line never affects the others
+	Parameters:	1) const string_view ptr lines	- Lines to evaluate
+				2) size_t count					- Number of lines
+				3) EvaluationContext ref context- Reference to the context used without a pool
+				4) BulkEvaluator ptr pool		- Pool to evaluate across; null evaluates in place
+				5) int ptr results				- Receives each line's value
+				6) EvaluationStatus ptr statuses- Receives each line's status
+	Returns:	void
+*/
+void evaluateDriverBatch(const std::string_view* lines, size_t count, EvaluationContext& context, BulkEvaluator* pool, int* results, EvaluationStatus* statuses)
+{
+	if (pool != nullptr)
+	{
+		pool->evaluateAll(lines, count, results, statuses);
+		return;
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		statuses[i] = evaluate(lines[i], context, results[i]);
+	}
+}
+
+/*	Struct:		A line with the text output the driver must give for it
+*/
+struct KnownDriverLine
+{
+	const char* line;
+	const char* output;
+};
+
+// Lines that once took the whole run down, or that sit on the edge of int
+const KnownDriverLine knownDriverLines[] =
+{
+	{ "(-2147483647-1)/-1",		"-2147483648" },
+	{ "abs(-2147483647-1)",		"-2147483648" },
+	{ "",						"error: Empty expression at offset 0" },
+	{ "1/0",					"error: Division by zero at offset 1" },
+	{ "2147483647+1",			"-2147483648" },
+	{ "-(-2147483647-1)",		"-2147483648" },
+	{ "4 + ( 12 / 2 )",			"10" }
+};
+
+/*	Function:	- Check the driver's text output for knownDriverLines, evaluated as one batch
+					both in place & across a pool
+				- Mismatches are printed to stderr
+	Returns:	bool - Whether or not every line gave its expected output
+*/
+bool runDriverSelfTest()
+{
+	const size_t count = sizeof(knownDriverLines) / sizeof(knownDriverLines[0]);
+	std::vector<std::string_view> lines;
+	std::vector<int> results(count);
+	std::vector<EvaluationStatus> statuses(count);
+	EvaluationContext context;
+	BulkEvaluator pool(2);
+	bool passed = true;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		lines.push_back(knownDriverLines[i].line);
+	}
+
+	for (BulkEvaluator* batchPool : { static_cast<BulkEvaluator*>(nullptr), &pool })
+	{
+		evaluateDriverBatch(lines.data(), count, context, batchPool, results.data(), statuses.data());
+
+		for (size_t i = 0; i < count; i++)
+		{
+			std::string text;
+			appendTextResult(results[i], statuses[i], text);
+			text.pop_back();
+
+			if (text != knownDriverLines[i].output)
+			{
+				std::fprintf(stderr, "Self-test (%s): \"%s\" gave \"%s\", expected \"%s\"\n", batchPool != nullptr ? "pool" : "in place",
+					knownDriverLines[i].line, text.c_str(), knownDriverLines[i].output);
+				passed = false;
+			}
+		}
+	}
+
+	std::printf("Self-test: %s\n", passed ? "passed" : "failed");
+	return passed;
+}
+
+int main(int argc, char** argv)
+{
+	DriverOptions options;
+
+	if (!parseDriverOptions(argc, argv, options))
+	{
+		printUsage(stderr);
+		return 1;
+	}
+
+	if (options.showHelp)
+	{
+		printUsage(stdout);
+		return 0;
+	}
+
+	if (options.selfTest)
+	{
+		return runDriverSelfTest() ? 0 : 1;
+	}
+
+	LineReader reader;
+
+	if (!reader.open(options.inputPath))
+	{
+		std::fprintf(stderr, "Cannot open %s\n", options.inputPath);
+		return 1;
+	}
+
+	setEvaluationLimits(options.limits);
+
+	// One thread evaluates in place; more share the batch across a pool kept for the whole run
+	EvaluationContext context;
+	std::unique_ptr<BulkEvaluator> pool;
+
+	if (options.threadCount != 1)
+	{
+		pool = std::make_unique<BulkEvaluator>(options.threadCount);
+	}
+
+	std::vector<std::string_view> lines;
+	std::vector<int> results;
+	std::vector<EvaluationStatus> statuses;
+	std::vector<LineResult> records;
+	std::string text;
+	size_t lineCount = 0;
+	size_t failureCount = 0;
+	double stageSeconds[3] = {};
+
+	lines.reserve(options.batchSize);
+
+	while (true)
+	{
+		auto start = std::chrono::steady_clock::now();
+		const bool haveLines = reader.readBatch(options.batchSize, lines);
+		auto stop = std::chrono::steady_clock::now();
+		stageSeconds[0] += std::chrono::duration<double>(stop - start).count();
+
+		if (!haveLines)
+		{
+			break;
+		}
+
+		const size_t count = lines.size();
+		results.assign(count, 0);
+		statuses.resize(count);
+		start = stop;
+
+		evaluateDriverBatch(lines.data(), count, context, pool.get(), results.data(), statuses.data());
+		stop = std::chrono::steady_clock::now();
+		stageSeconds[1] += std::chrono::duration<double>(stop - start).count();
+		start = stop;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			failureCount += statuses[i] ? 0 : 1;
+		}
+
+		bool written = true;
+
+		if (options.output == DriverOutput::Text)
+		{
+			text.clear();
+
+			for (size_t i = 0; i < count; i++)
+			{
+				appendTextResult(results[i], statuses[i], text);
+			}
 
-				if (currentToken == "+")
-				{				
-					arg1 = valueStack.top();
-					valueStack.pop();
-					arg2 = valueStack.top();
-					valueStack.pop();
+			written = std::fwrite(text.data(), 1, text.size(), stdout) == text.size();
+		}
+
+		else if (options.output == DriverOutput::Binary)
+		{
+			records.resize(count);
+
+			for (size_t i = 0; i < count; i++)
+			{
+				records[i].result = statuses[i] ? results[i] : 0;
+				records[i].status = statuses[i];
+			}
+
+			written = std::fwrite(records.data(), sizeof(LineResult), count, stdout) == count;
+		}
+
+		// Every finished batch reaches the output, even if a later one never does
+		written = std::fflush(stdout) == 0 && written;
+
+		stageSeconds[2] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		lineCount += count;
+
+		if (!written)
+		{
+			std::fprintf(stderr, "Cannot write results\n");
+			return 1;
+		}
+	}
+
+	std::fflush(stdout);
+
+	if (reader.failed())
+	{
+		std::fprintf(stderr, "Cannot read input\n");
+		return 1;
+	}
+
+	if (options.printStats)
+	{
+		printDriverStats(lineCount, reader.bytesRead(), failureCount, stageSeconds, pool ? pool->stats() : context.stats());
+	}
+
+	return 0;
+}
+#pragma endregion
+#elif defined(SHUNTING_YARD_BENCHMARK)
+#pragma region Benchmarks
+/*	Benchmark build
+	- Built by defining SHUNTING_YARD_BENCHMARK, which replaces the command-line driver
+	- Measures tokenising, shunting & calculation separately as well as end to end,
+		over expressions of 3 to 1M tokens in several shapes
+	- Reports time per call, ns/token, heap allocations per call & token throughput
+	- An optional argument filters benchmarks by substring, e.g. "Shunt/DeepNesting"
+*/
+// Global allocation counter; every operator new in the benchmark build passes through here
+std::atomic<size_t> benchmarkAllocations(0);
+
+// Kept out of line so the compiler does not pair the inlined malloc & free calls
+//		with library operator new/delete & warn about a mismatch
+#if defined(__GNUC__)
+#define SY_NOINLINE __attribute__((noinline))
+#else
+#define SY_NOINLINE
+#endif
+
+SY_NOINLINE void* operator new(size_t size)
+{
+	benchmarkAllocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* memory = std::malloc(size != 0 ? size : 1))
+	{
+		return memory;
+	}
+
+	throw std::bad_alloc();
+}
+
+SY_NOINLINE void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+SY_NOINLINE void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+// Written to by every benchmark body so the optimiser cannot discard the work
+volatile int benchmarkSink = 0;
+
+// Minimum measured time per benchmark before the iteration count stops growing
+const double benchmarkMinimumSeconds = 0.1;
+
+/*	Struct:		A named expression to benchmark, with its token count
+*/
+struct BenchmarkInput
+{
+	std::string name;
+	std::string expression;
+	size_t tokenCount;
+};
+
+/*	Function:	Count the tokens in an expression using the Lexer
+	Parameters:	1) string_view expression	- Expression to count
+	Returns:	size_t - Number of tokens
+*/
+size_t countTokens(std::string_view expression)
+{
+	Lexer lexer(expression);
+	Token token;
+	size_t count = 0;
+
+	while (lexer.next(token))
+	{
+		count++;
+	}
+
+	return count;
+}
+
+/*	Functions:	Build benchmark expressions of roughly the requested token count
+				- Flat sum:		"1 + 1 + ... + 1"
+				- Deep nesting:	"( 1 + ( 1 + ( ... ) ) )"
+				- Mixed:		"( 7 * 3 ) - ( 8 / 2 ) + ( 7 * 3 ) - ..."
+	Parameters:	1) size_t tokenCount	- Approximate number of tokens wanted
+	Returns:	BenchmarkInput
+*/
+BenchmarkInput makeFlatSum(size_t tokenCount)
+{
+	std::string expression = "1";
+
+	while (expression.size() / 2 + 1 < tokenCount)
+	{
+		expression += " + 1";
+	}
+
+	return { "FlatSum", expression, countTokens(expression) };
+}
+
+BenchmarkInput makeDeepNesting(size_t tokenCount)
+{
+	const size_t depth = std::max<size_t>(1, tokenCount / 4);
+	std::string expression;
+
+	for (size_t i = 0; i < depth; i++)
+	{
+		expression += "( 1 + ";
+	}
+
+	expression += "1";
+	expression.append(depth * 2, ' ');
+
+	for (size_t i = 0; i < depth; i++)
+	{
+		expression[expression.size() - depth * 2 + i * 2 + 1] = ')';
+	}
+
+	return { "DeepNesting", expression, countTokens(expression) };
+}
+
+BenchmarkInput makeMixed(size_t tokenCount)
+{
+	static const char* const groups[2] = { "( 7 * 3 )", "( 8 / 2 )" };
+	std::string expression = groups[0];
+	size_t group = 1;
+
+	// Each group is 5 tokens, joined to the previous one by an operator
+	for (size_t tokens = 11; tokens <= tokenCount || group == 1; tokens += 6)
+	{
+		expression += group % 2 == 1 ? " - " : " + ";
+		expression += groups[group % 2];
+		group++;
+	}
+
+	return { "Mixed", expression, countTokens(expression) };
+}
+
+/*	Function:	- Time a benchmark body, growing the iteration count until the
+					run lasts at least benchmarkMinimumSeconds
+				- Prints one result row in the style of Google Benchmark
+	Parameters:	1) const char ptr stage			- Pipeline stage being measured
+				2) BenchmarkInput ref input		- Expression being measured
+				3) const char ptr filter		- Only run if the benchmark name contains this; may be null
+				4) Body body					- Callable performing one call of the stage
+	Returns:	void
+*/
+template <typename Body>
+void runBenchmark(const char* stage, const BenchmarkInput& input, const char* filter, Body body)
+{
+	const std::string name = std::string(stage) + "/" + input.name + "/" + std::to_string(input.tokenCount);
+
+	if (filter != nullptr && name.find(filter) == std::string::npos)
+	{
+		return;
+	}
+
+	// Warm up caches & scratch buffers so steady-state behaviour is measured
+	body();
+
+	size_t iterations = 1;
+	double seconds = 0.0;
+	size_t allocations = 0;
+
+	while (true)
+	{
+		const size_t allocationsBefore = benchmarkAllocations.load(std::memory_order_relaxed);
+		const auto start = std::chrono::steady_clock::now();
+
+		for (size_t i = 0; i < iterations; i++)
+		{
+			body();
+		}
+
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		allocations = benchmarkAllocations.load(std::memory_order_relaxed) - allocationsBefore;
+
+		if (seconds >= benchmarkMinimumSeconds || iterations >= 1000000000)
+		{
+			break;
+		}
+
+		// Aim past the minimum time, growing at most tenfold per round
+		const double scale = seconds > 0.0 ? benchmarkMinimumSeconds * 1.4 / seconds : 10.0;
+		iterations = static_cast<size_t>(iterations * std::min(10.0, std::max(2.0, scale)));
+	}
+
+	const double nanosecondsPerCall = seconds * 1e9 / iterations;
+
+	std::printf("%-36s %14.1f %12zu %10.2f %12.2f %14.3e\n",
+		name.c_str(),
+		nanosecondsPerCall,
+		iterations,
+		nanosecondsPerCall / input.tokenCount,
+		static_cast<double>(allocations) / iterations,
+		input.tokenCount * iterations / seconds);
+}
+
+int main(int argc, char** argv)
+{
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+	const size_t tokenCounts[5] = { 3, 100, 10000, 100000, 1000000 };
+
+	std::vector<BenchmarkInput> inputs;
+
+	for (size_t i = 0; i < 5; i++)
+	{
+		inputs.push_back(makeFlatSum(tokenCounts[i]));
+		inputs.push_back(makeDeepNesting(tokenCounts[i]));
+		inputs.push_back(makeMixed(tokenCounts[i]));
+	}
+
+	std::printf("%-36s %14s %12s %10s %12s %14s\n", "Benchmark", "Time(ns)", "Iterations", "ns/token", "allocs/call", "tokens/s");
+	std::printf("%s\n", std::string(103, '-').c_str());
+
+	for (size_t i = 0; i < inputs.size(); i++)
+	{
+		const BenchmarkInput& input = inputs[i];
+		ShuntingYard shunter;
+		RPN rpn;
+		EvaluationContext context;
+		std::vector<Instruction> program;
+		int result = 0;
+
+		// Tokenising only
+		runBenchmark("Tokenise", input, filter, [&]
+		{
+			benchmarkSink = static_cast<int>(countTokens(input.expression));
+		});
+
+		// Tokenising & shunting into bytecode
+		runBenchmark("Shunt", input, filter, [&]
+		{
+			program.clear();
+			benchmarkSink = static_cast<int>(shunter.shuntInfixToRPN(input.expression, program).error);
+		});
+
+		// Calculating a shunted program
+		program.clear();
+		shunter.shuntInfixToRPN(input.expression, program);
+
+		runBenchmark("CalculatePostfix", input, filter, [&]
+		{
+			rpn.calculatePostfix(program.data(), program.size(), result);
+			benchmarkSink = result;
+		});
+
+		// Running the same program as native code, where it can be lowered
+		NativeProgram native;
+
+		if (native.compile(program.data(), program.size()))
+		{
+			runBenchmark("Native", input, filter, [&]
+			{
+				unsigned int failedInstruction = UINT_MAX;
+				benchmarkSink = native.function()(nullptr, &failedInstruction);
+			});
+		}
+
+		// Running the same program in register form, without a value stack
+		RegisterProgram registerProgram;
+
+		if (registerProgram.lower(program.data(), program.size(), shunter.offsets().data(), 0))
+		{
+			runBenchmark("Register", input, filter, [&]
+			{
+				registerProgram.evaluate(nullptr, result);
+				benchmarkSink = result;
+			});
+		}
+
+		// Calculating the same expression over BigInteger, which stays on its inline fast path
+		//		until a value overflows int64_t
+		TypedExpression<BigInteger> wide;
+
+		if (compile(input.expression, wide))
+		{
+			BigInteger wideResult;
+
+			runBenchmark("BigInteger", input, filter, [&]
+			{
+				evaluate(wide, static_cast<const BigInteger*>(nullptr), wideResult);
+				benchmarkSink = static_cast<int>(wideResult.smallValue());
+			});
+		}
+
+		// Tokenise, shunt & calculate
+		runBenchmark("EndToEnd", input, filter, [&]
+		{
+			evaluate(input.expression, context, result);
+			benchmarkSink = result;
+		});
+	}
+
+	return 0;
+}
+#pragma endregion
+#else
+#pragma region Differential Fuzzing
+/*	Fuzz build
+	- Built by defining SHUNTING_YARD_FUZZ, which replaces the command-line driver
+	- Generates random expressions in several shapes & checks every optimised path against the
+		original string engine: whitespace-separated tokens shunted by
+		ShuntingYard::shuntInfixToRPN & calculated by RPN::calculatePostfix
+	- The string engine has no operator precedence & no unary minus, so generated expressions
+		are fully bracketed binary operations over non-negative literals, with no zero divisor
+	- Intermediate values stay inside int, except for INT_MIN / -1, which is built on purpose
+		from ( ( 0 - 2147483647 ) - 1 ) / ( 0 - 1 ) & must wrap to INT_MIN on every path
+	- The optimised paths also get the same expression with minimal brackets, no whitespace &
+		variables in place of some literals; there, some subtractions from 0 are written as a
+		leading -, & some leaves & INT_MIN subtrees are wrapped in abs(), neither of which
+		changes the value
+	- Then times the string engine against the optimised paths & reports the speedup per shape
+	- Arguments: [cases per shape] [seed]; exits with 1 if any path disagreed
+*/
+// Leaf values per generated expression; each may be written as a literal or as variable vN
+const size_t fuzzLeafCount = 8;
+
+// Leaves with fixed values after the random ones, used to build INT_MIN & -1: 0, 1 & INT_MAX
+// Always written as literals
+const size_t fuzzFixedLeafCount = 3;
+const unsigned int fuzzZeroLeaf = fuzzLeafCount;
+const unsigned int fuzzOneLeaf = fuzzLeafCount + 1;
+const unsigned int fuzzMaximumLeaf = fuzzLeafCount + 2;
+
+// Largest operator count of an expression checked for divergence
+const size_t fuzzMaximumOperators = 64;
+
+// Divergences printed in full before the rest are only counted
+const size_t fuzzReportLimit = 10;
+
+// Minimum measured time per timing row before the pass count stops growing
+const double fuzzMinimumSeconds = 0.1;
+
+// Written to by every timed pass so the optimiser cannot discard the work
+volatile int fuzzSink = 0;
+
+/*	Enum:		Shape of a generated expression tree
+*/
+enum class FuzzShape
+{
+	Balanced,		// Both operands of every operator hold half the remaining operators
+	LeftChain,		// ( ( ( a + b ) + c ) + d )
+	RightChain,		// ( a + ( b + ( c + d ) ) )
+	Random			// Operators split between the operands at random
+};
+
+const size_t fuzzShapeCount = 4;
+const char* const fuzzShapeNames[fuzzShapeCount] = { "Balanced", "LeftChain", "RightChain", "Random" };
+
+/*	Struct:		One node of a generated expression tree
+*/
+struct FuzzNode
+{
+	char symbol = 0;			// '+', '-', '*' or '/'; 0 for a leaf
+	unsigned int leaf = 0;		// Index into FuzzCase::leafValues, for leaves
+	size_t lhs = 0;				// Node of the left operand, for operators
+	size_t rhs = 0;				// Node of the right operand, for operators
+	int value = 0;				// Value of the subtree, as the string engine calculates it
+	bool unary = false;			// A subtraction from a 0 leaf, written compactly as -rhs
+	bool absolute = false;		// Written compactly as abs(...); only set where that keeps the value
+};
+
+/*	Struct:		A generated expression tree; the root is the last node
+*/
+struct FuzzCase
+{
+	std::vector<FuzzNode> nodes;
+	int leafValues[fuzzLeafCount + fuzzFixedLeafCount] = {};
+	bool wrapped = false;			// Whether INT_MIN / -1 occurs, so wider value types disagree
+
+	int value() const { return nodes.back().value; }
+};
+
+/*	Class:		- Seeded generator of random expression trees
+				- Each operator is picked among those whose result stays inside int (or is
+					INT_MIN / -1) without a zero divisor; one always is, as a + 0 cannot
+					overflow & any other divisor leaves / in range
+				- Some subtrees of four operators are INT_MIN / -1 itself
+				- Marks some nodes to be rendered compactly through unary minus or abs()
+*/
+class ExpressionGenerator
+{
+	public:
+		explicit ExpressionGenerator(unsigned int seed) : random(seed) {}
+
+		void generate(FuzzShape shape, size_t operatorCount, FuzzCase& fuzzCase);
+
+		// Uniformly distributed value in [0, bound)
+		unsigned int next(unsigned int bound) { return static_cast<unsigned int>(random() % bound); }
+
+	private:
+		size_t addSubtree(FuzzShape shape, size_t operatorCount, FuzzCase& fuzzCase);
+		size_t addOperator(size_t lhs, size_t rhs, FuzzCase& fuzzCase, char symbol = 0);
+		size_t addLeaf(unsigned int leaf, FuzzCase& fuzzCase);
+		size_t addWrappingQuotient(FuzzCase& fuzzCase);
+
+		std::mt19937 random;
+};
+
+/*	Function:	Generate a new expression tree, replacing the previous contents of fuzzCase
+	Parameters:	1) FuzzShape shape			- Shape of the tree
+				2) size_t operatorCount		- Number of operators in the tree
+				3) FuzzCase ref fuzzCase	- Reference to the case receiving the tree
+	Returns:	void
+*/
+void ExpressionGenerator::generate(FuzzShape shape, size_t operatorCount, FuzzCase& fuzzCase)
+{
+	fuzzCase.nodes.clear();
+	fuzzCase.wrapped = false;
+	fuzzCase.leafValues[fuzzZeroLeaf] = 0;
+	fuzzCase.leafValues[fuzzOneLeaf] = 1;
+	fuzzCase.leafValues[fuzzMaximumLeaf] = INT_MAX;
+
+	// Mostly small literals, so zero divisors & small quotients are common, with
+	//		some values near the top of int to exercise overflow avoidance & parsing
+	for (size_t i = 0; i < fuzzLeafCount; i++)
+	{
+		const unsigned int range = next(10);
+		fuzzCase.leafValues[i] = static_cast<int>(range < 6 ? next(10) : range < 9 ? next(1000) : random() % INT_MAX);
+	}
+
+	addSubtree(shape, operatorCount, fuzzCase);
+}
+
+/*	Function:	Add a subtree of the given shape, operands before the operator
+	Parameters:	1) FuzzShape shape			- Shape of the subtree
+				2) size_t operatorCount		- Number of operators in the subtree
+				3) FuzzCase ref fuzzCase	- Reference to the case receiving the nodes
+	Returns:	size_t - Node of the subtree's root
+*/
+size_t ExpressionGenerator::addSubtree(FuzzShape shape, size_t operatorCount, FuzzCase& fuzzCase)
+{
+	if (operatorCount == 0)
+	{
+		return addLeaf(next(fuzzLeafCount), fuzzCase);
+	}
+
+	if (operatorCount == 4 && next(8) == 0)
+	{
+		return addWrappingQuotient(fuzzCase);
+	}
+
+	// Operators left once this one is placed, split between the two operands
+	const size_t remaining = operatorCount - 1;
+	size_t lhsOperators = 0;
+
+	switch (shape)
+	{
+		case FuzzShape::Balanced:	lhsOperators = remaining / 2; break;
+		case FuzzShape::LeftChain:	lhsOperators = remaining; break;
+		case FuzzShape::RightChain:	lhsOperators = 0; break;
+		case FuzzShape::Random:		lhsOperators = next(static_cast<unsigned int>(remaining + 1)); break;
+	}
+
+	const size_t lhs = addSubtree(shape, lhsOperators, fuzzCase);
+	const size_t rhs = addSubtree(shape, remaining - lhsOperators, fuzzCase);
+	return addOperator(lhs, rhs, fuzzCase);
+}
+
+/*	Function:	Add a leaf
+	Parameters:	1) unsigned int leaf		- Index into FuzzCase::leafValues
+				2) FuzzCase ref fuzzCase	- Reference to the case receiving the node
+	Returns:	size_t - Node of the leaf
+*/
+size_t ExpressionGenerator::addLeaf(unsigned int leaf, FuzzCase& fuzzCase)
+{
+	FuzzNode node;
+	node.leaf = leaf;
+	node.value = fuzzCase.leafValues[leaf];
+
+	// Leaves are never negative, so abs() leaves them as they are
+	node.absolute = next(8) == 0;
+	fuzzCase.nodes.push_back(node);
+	return fuzzCase.nodes.size() - 1;
+}
+
+/*	Function:	Add ( ( 0 - INT_MAX ) - 1 ) / ( 0 - 1 ), the one quotient that overflows int
+	Parameters:	1) FuzzCase ref fuzzCase	- Reference to the case receiving the nodes
+	Returns:	size_t - Node of the division
+*/
+size_t ExpressionGenerator::addWrappingQuotient(FuzzCase& fuzzCase)
+{
+	const size_t negativeMaximum = addOperator(addLeaf(fuzzZeroLeaf, fuzzCase), addLeaf(fuzzMaximumLeaf, fuzzCase), fuzzCase, '-');
+	const size_t minimum = addOperator(negativeMaximum, addLeaf(fuzzOneLeaf, fuzzCase), fuzzCase, '-');
+
+	// abs(INT_MIN) wraps back to INT_MIN
+	fuzzCase.nodes[minimum].absolute = next(2) == 0;
+	const size_t minusOne = addOperator(addLeaf(fuzzZeroLeaf, fuzzCase), addLeaf(fuzzOneLeaf, fuzzCase), fuzzCase, '-');
+	return addOperator(minimum, minusOne, fuzzCase, '/');
+}
+
+/*	Function:	Add an operator over two subtrees, starting from a random one & moving on
+					to the next while the result would leave int or divide by zero
+	Parameters:	1) size_t lhs				- Node of the left operand
+				2) size_t rhs				- Node of the right operand
+				3) FuzzCase ref fuzzCase	- Reference to the case receiving the node
+				4) char symbol				- Operator to use rather than a random one; must be valid
+	Returns:	size_t - Node of the operator
+*/
+size_t ExpressionGenerator::addOperator(size_t lhs, size_t rhs, FuzzCase& fuzzCase, char symbol)
+{
+	static const char symbols[4] = { '+', '-', '*', '/' };
+	const long long lhsValue = fuzzCase.nodes[lhs].value;
+	const long long rhsValue = fuzzCase.nodes[rhs].value;
+	const unsigned int first = next(4);
+
+	FuzzNode node;
+	node.lhs = lhs;
+	node.rhs = rhs;
+
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		long long value = 0;
+		node.symbol = symbol != 0 ? symbol : symbols[(first + i) % 4];
 
-					// Place the result back on top of the stack,
-					//		to use in future operations
-					int tmpResult = arg1 + arg2;
-					valueStack.push(tmpResult);
+		switch (node.symbol)
+		{
+			case '+': value = lhsValue + rhsValue; break;
+			case '-': value = lhsValue - rhsValue; break;
+			case '*': value = lhsValue * rhsValue; break;
+			case '/':
+				if (rhsValue == 0)
+				{
+					continue;
 				}
 
-				else if (currentToken == "-")
+				// Wraps to INT_MIN on every int path
+				if (lhsValue == INT_MIN && rhsValue == -1)
 				{
-					arg1 = valueStack.top();
-					valueStack.pop();
-					arg2 = valueStack.top();
-					valueStack.pop();
-
-					// Place the result back on top of the stack,
-					//		to use in future operations
-					int tmpResult = arg1 - arg2;
-					valueStack.push(tmpResult);
+					fuzzCase.wrapped = true;
+					value = INT_MIN;
+					break;
 				}
 
-				else if (currentToken == "*")
-				{
-					arg1 = valueStack.top();
-					valueStack.pop();
-					arg2 = valueStack.top();
-					valueStack.pop();
+				value = lhsValue / rhsValue;
+				break;
+		}
 
-					// Place the result back on top of the stack,
-					//		to use in future operations
-					int tmpResult = arg1 * arg2;
-					valueStack.push(tmpResult);
-				}
-				
-				if (currentToken == "/")
-				{
-					arg1 = valueStack.top();
-					valueStack.pop();
-					arg2 = valueStack.top();
-					valueStack.pop();
+		if (value >= INT_MIN && value <= INT_MAX)
+		{
+			node.value = static_cast<int>(value);
+			break;
+		}
+	}
 
-					// Place the result back on top of the stack,
-					//		to use in future operations
-					// arg2 given first as the order for the division is
-					//		reversed when placed on the stack
-					int tmpResult = arg2 / arg1;
-					valueStack.push(tmpResult);
-				}
-			}
+	// 0 - x & -x agree, wrapping included
+	const FuzzNode& lhsNode = fuzzCase.nodes[lhs];
+	node.unary = node.symbol == '-' && lhsNode.symbol == 0 && lhsNode.value == 0 && !lhsNode.absolute && next(2) == 0;
+	fuzzCase.nodes.push_back(node);
+	return fuzzCase.nodes.size() - 1;
+}
 
-			else
-			{
-				// Operation failed, return false
-				std::cout << "Not enough arguements. Evaluation failed \n";
-				return false;
-			}
+/*	Function:	Write a subtree in the string engine's syntax: every operator bracketed &
+					every token separated by a space
+	Parameters:	1) FuzzCase ref fuzzCase	- Case holding the tree
+				2) size_t node				- Root of the subtree to write
+				3) bool bracket				- Whether to bracket an operator at the root
+				4) string ref expression	- Reference to the string receiving the text
+	Returns:	void
+*/
+void renderBracketed(const FuzzCase& fuzzCase, size_t node, bool bracket, std::string& expression)
+{
+	const FuzzNode& current = fuzzCase.nodes[node];
+
+	if (current.symbol == 0)
+	{
+		expression += std::to_string(fuzzCase.leafValues[current.leaf]);
+		return;
+	}
+
+	if (bracket)
+	{
+		expression += "( ";
+	}
+
+	renderBracketed(fuzzCase, current.lhs, true, expression);
+	expression += ' ';
+	expression += current.symbol;
+	expression += ' ';
+	renderBracketed(fuzzCase, current.rhs, true, expression);
+
+	if (bracket)
+	{
+		expression += " )";
+	}
+}
+
+/*	Function:	- Write a subtree with only the brackets precedence needs & no whitespace
+				- A right operand of equal precedence stays bracketed, as a * ( b / c ) &
+					a - ( b - c ) do not reassociate
+				- Nodes marked absolute are written inside abs(), & unary ones as -rhs
+	Parameters:	1) FuzzCase ref fuzzCase		- Case holding the tree
+				2) size_t node					- Root of the subtree to write
+				3) unsigned int variableMask	- Leaves whose bit is set are written as vN, not as literals
+				4) string ref expression		- Reference to the string receiving the text
+				5) bool inAbsolute				- Whether the node's abs() has already been written
+	Returns:	void
+*/
+void renderCompact(const FuzzCase& fuzzCase, size_t node, unsigned int variableMask, std::string& expression,
+	bool inAbsolute = false)
+{
+	const FuzzNode& current = fuzzCase.nodes[node];
+
+	if (current.absolute && !inAbsolute)
+	{
+		expression += "abs(";
+		renderCompact(fuzzCase, node, variableMask, expression, true);
+		expression += ')';
+		return;
+	}
+
+	if (current.symbol == 0)
+	{
+		if (variableMask & (1u << current.leaf))
+		{
+			expression += 'v';
+			expression += std::to_string(current.leaf);
 		}
 
-		// Otherwise, something is wrong
 		else
 		{
-			std::cout << "Invalid expression. Returning 0.";
-			return false;
+			expression += std::to_string(fuzzCase.leafValues[current.leaf]);
 		}
 
-	} // End for() loop - Iteration over input tokens
+		return;
+	}
 
-	// Set final result
-	// Return true; successful evaluation
-	result = valueStack.top();
-	return true;
+	// Leaves & abs() bind tightest, then * & /, then + & -; a unary minus is bracketed as a subtraction
+	auto precedence = [&](size_t operand)
+	{
+		const char symbol = fuzzCase.nodes[operand].symbol;
+		return symbol == 0 || fuzzCase.nodes[operand].absolute ? 3 : (symbol == '*' || symbol == '/') ? 2 : 1;
+	};
+
+	const bool bracketRhs = precedence(current.rhs) <= precedence(node);
+
+	if (current.unary)
+	{
+		expression += '-';
+		expression += bracketRhs ? "(" : "";
+		renderCompact(fuzzCase, current.rhs, variableMask, expression);
+		expression += bracketRhs ? ")" : "";
+		return;
+	}
+
+	const bool bracketLhs = precedence(current.lhs) < precedence(node);
+
+	expression += bracketLhs ? "(" : "";
+	renderCompact(fuzzCase, current.lhs, variableMask, expression);
+	expression += bracketLhs ? ")" : "";
+	expression += current.symbol;
+	expression += bracketRhs ? "(" : "";
+	renderCompact(fuzzCase, current.rhs, variableMask, expression);
+	expression += bracketRhs ? ")" : "";
 }
-#pragma endregion
 
-/*	Function:	- Evaluates a string-based mathematical expression
-				- Tokenises string
-				- Applies Shunting-Yard to create postfix expression
-				- Calculates postfix expression
-				- Provides results, and notifies if calculation (un)successful
+/*	Function:	Bind the variables vN named by a compiled program to the case's leaf values
+	Parameters:	1) Vector<string> ref names		- Variable names in the program's order
+				2) FuzzCase ref fuzzCase		- Case holding the leaf values
+				3) Vector<Value> ref values		- Reference to the collection receiving the values
+	Returns:	void
+*/
+template <typename Value>
+void bindFuzzVariables(const std::vector<std::string>& names, const FuzzCase& fuzzCase, std::vector<Value>& values)
+{
+	values.clear();
+
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		values.push_back(Value{ fuzzCase.leafValues[std::atoi(names[i].c_str() + 1)] });
+	}
+}
 
+/*	Function:	- The sample's original evaluate(): tokenise by whitespace with an istringstream,
+					shunt to postfix strings & calculate them
+				- Used as the reference the optimised paths must agree with
 	Parameters:	1) String ref expression	- Reference to the string defining the expression
 				2) Int ref result			- Reference to the variable for storing results
-											- Pass-by-reference used to directly modify the
-												result value to be displayed withotu having to return
-												a value & allows the method to return true/false for
-												a successfuly calculation
-
 	Returns:	bool - Whether or not the evaluation was successful
 */
-bool evaluate(const std::string& expression, int &result)
+bool evaluateLegacy(const std::string& expression, int& result)
 {
-	// Create new ShuntingYard instance to convert from
-	//		infix to postfix notation
 	ShuntingYard shunter;
-
-	// Create new RPN instance to calculate results from
-	//		the postfix expression
 	RPN rpn;
-
-	// Variable to store expression result
-	int expressionResult;
-
-	// Tokenise expression
-	// istringstream used as it can easily separate the expression
-	//		using whitespace
-	// Disadvantage of requiring whitespace between all operators
 	std::istringstream tokeniser(expression);
-	std::vector<std::string> tokens;										// Vector to store expression tokens
-	std::vector<std::string> shuntedOutput;									// Vector to store shunted postfix output
+	std::vector<std::string> tokens;
+	std::vector<std::string> shuntedOutput;
 
-	// While we are reading the string
+	// Reads one empty token once the stream runs out, which the shunt skips
 	while (tokeniser)
 	{
-		// Temporary string to store token
 		std::string temp;
-
-		// Store the currently retreived token in
-		//		the temporary string
 		tokeniser >> temp;
-
-		// Add the currently retrieved token to
-		//		the collection of tokens
 		tokens.push_back(temp);
 	}
 
-	// Convert infix to RPN using Shunting Yard
-	// Provide Shunting Yard with tokens to convert
-	//		as well as a variable to store the output
-	if (shunter.shuntInfixToRPN(tokens, shuntedOutput))
+	return shunter.shuntInfixToRPN(tokens, shuntedOutput) && rpn.calculatePostfix(shuntedOutput, result);
+}
+
+/*	Class:		Tally of the checks made against the string engine & of the divergences found
+*/
+class DivergenceLog
+{
+	public:
+		void check(FuzzShape shape, const char* path, const std::string& expression, int expected,
+			EvaluationStatus status, int result);
+
+		size_t checks() const { return checkCount; }
+		size_t divergences() const { return divergenceCount; }
+
+	private:
+		size_t checkCount = 0;
+		size_t divergenceCount = 0;
+};
+
+/*	Function:	Record one path's outcome, printing it if it disagrees with the string engine
+	Parameters:	1) FuzzShape shape			- Shape of the expression
+				2) const char ptr path		- Name of the path checked
+				3) String ref expression	- Expression as given to the path
+				4) int expected				- String engine's result
+				5) EvaluationStatus status	- Path's status
+				6) int result				- Path's result; only meaningful on success
+	Returns:	void
+*/
+void DivergenceLog::check(FuzzShape shape, const char* path, const std::string& expression, int expected,
+	EvaluationStatus status, int result)
+{
+	checkCount++;
+
+	if (status && result == expected)
 	{
-		std::cout << "Expression successfully shunted \n";
+		return;
 	}
 
-	else
+	if (divergenceCount++ < fuzzReportLimit)
 	{
-		std::cout << "\n Shunt failed \n";
-		return false;
+		// Long expressions are cut short; the seed reproduces them in full
+		const std::string shown = expression.size() > 160 ? expression.substr(0, 160) + " ..." : expression;
+
+		std::printf("DIVERGENCE %s/%s: %s\n    expected %d, got ", fuzzShapeNames[static_cast<size_t>(shape)],
+			path, shown.c_str(), expected);
+
+		if (status)
+		{
+			std::printf("%d\n", result);
+		}
+
+		else
+		{
+			std::printf("%s at offset %u\n", describeError(status.error), status.offset);
+		}
 	}
+}
+
+/*	Function:	Run one generated case through the string engine & every optimised path
+	Parameters:	1) FuzzShape shape					- Shape of the case
+				2) FuzzCase ref fuzzCase			- Case to check
+				3) ExpressionGenerator ref generator	- Source of variable masks & stream chunk sizes
+				4) DivergenceLog ref log			- Reference to the tally receiving the outcomes
+	Returns:	void
+*/
+void checkFuzzCase(FuzzShape shape, const FuzzCase& fuzzCase, ExpressionGenerator& generator, DivergenceLog& log)
+{
+	const size_t root = fuzzCase.nodes.size() - 1;
+	std::string bracketed;
+	std::string compact;
+	std::string withVariables;
+
+	renderBracketed(fuzzCase, root, false, bracketed);
+	renderCompact(fuzzCase, root, 0, compact);
+	renderCompact(fuzzCase, root, generator.next(1u << fuzzLeafCount), withVariables);
 
-	// Calculate result using RPN
-	// Provide tokens to convert as well as a variable
-	//		 to store the output
-	if (rpn.calculatePostfix(shuntedOutput, result))
+	// The string engine should agree with the generator's own calculation before it is used as the reference
+	int expected = 0;
+	const bool legacyValid = evaluateLegacy(bracketed, expected);
+	log.check(shape, "Legacy", bracketed, fuzzCase.value(), legacyValid ? EvaluationStatus() :
+		EvaluationStatus{ EvaluationError::InvalidToken, 0 }, expected);
+
+	if (!legacyValid || expected != fuzzCase.value())
 	{
-		return true;
+		return;
 	}
 
-	else
+	int result = 0;
+	EvaluationStatus status;
+
+	// End to end, with & without whitespace
+	status = evaluate(bracketed, result);
+	log.check(shape, "Evaluate", bracketed, expected, status, result);
+
+	status = evaluate(compact, result);
+	log.check(shape, "EvaluateCompact", compact, expected, status, result);
+
+	// Shunted bytecode, calculated without the optimiser
+	ShuntingYard shunter;
+	RPN rpn;
+	std::vector<Instruction> program;
+	status = shunter.shuntInfixToRPN(compact, program);
+
+	if (status)
 	{
-		return false;
+		status = rpn.calculatePostfix(program.data(), program.size(), result);
+	}
+
+	log.check(shape, "Postfix", compact, expected, status, result);
+
+	// Streamed in random chunks, so tokens straddle chunk boundaries
+	StreamingEvaluator streaming;
+
+	for (size_t begin = 0; begin < compact.size(); )
+	{
+		const size_t length = 1 + generator.next(8);
+		streaming.feed(std::string_view(compact).substr(begin, length));
+		begin += length;
+	}
+
+	status = streaming.finish(result);
+	log.check(shape, "Stream", compact, expected, status, result);
+
+	// constexpr evaluator, run at run time; every token is a character, so the length bounds the slots needed
+	if (compact.size() <= 1024)
+	{
+		const ConstantEvaluation evaluation = evaluateConstant<1024>(compact);
+		log.check(shape, "Constant", compact, expected, evaluation.status, evaluation.value);
+	}
+
+	// Compiled paths, with some leaves read from variables
+	CompiledExpression compiled;
+	std::vector<int> variables;
+	status = compile(withVariables, compiled);
+
+	if (!status)
+	{
+		log.check(shape, "Compile", withVariables, expected, status, 0);
+		return;
+	}
+
+	bindFuzzVariables(compiled.variables(), fuzzCase, variables);
+
+	status = evaluate(compiled, variables.data(), result);
+	log.check(shape, "Compiled", withVariables, expected, status, result);
+
+	NativeProgram native;
+
+	if (native.compile(compiled.program().data(), compiled.program().size()))
+	{
+		unsigned int failedInstruction = UINT_MAX;
+		result = native.function()(variables.data(), &failedInstruction);
+		log.check(shape, "Native", withVariables, expected, failedInstruction == UINT_MAX ? EvaluationStatus() :
+			EvaluationStatus{ EvaluationError::DivisionByZero, failedInstruction }, result);
+	}
+
+	RegisterProgram registerProgram;
+	status = registerProgram.lower(compiled);
+
+	if (status)
+	{
+		status = registerProgram.evaluate(variables.data(), result);
+	}
+
+	log.check(shape, "Register", withVariables, expected, status, result);
+
+	// One row, with a column per variable
+	std::vector<const int*> columns;
+
+	for (size_t i = 0; i < variables.size(); i++)
+	{
+		columns.push_back(&variables[i]);
+	}
+
+	status = evaluateBatch(compiled, columns.data(), 1, &result, nullptr);
+	log.check(shape, "Batch", withVariables, expected, status, result);
+
+	// Arenas & graphs hold their own variable order
+	ProgramArena arena;
+	status = arena.add(withVariables);
+
+	if (status)
+	{
+		bindFuzzVariables(arena.variables(), fuzzCase, variables);
+		status = arena.evaluate(0, variables.data(), result);
+	}
+
+	log.check(shape, "Arena", withVariables, expected, status, result);
+
+	ExpressionGraph graph;
+	status = graph.add(withVariables);
+
+	if (status)
+	{
+		bindFuzzVariables(graph.variables(), fuzzCase, variables);
+		graph.evaluate(variables.data(), &result, &status);
+	}
+
+	log.check(shape, "Graph", withVariables, expected, status, result);
+
+	// The typed interpreter over int wraps like every other int path
+	TypedExpression<int> typed;
+	std::vector<int> typedVariables;
+	int typedResult = 0;
+	status = compile(withVariables, typed);
+
+	if (status)
+	{
+		bindFuzzVariables(typed.variables(), fuzzCase, typedVariables);
+		status = evaluate(typed, typedVariables.data(), typedResult);
+	}
+
+	log.check(shape, "Int", withVariables, expected, status, typedResult);
+
+	// Checked & wider value types must agree exactly, unless INT_MIN / -1 overflows or fits them
+	if (fuzzCase.wrapped)
+	{
+		return;
+	}
+
+	TypedExpression<Checked<int>> checked;
+	std::vector<Checked<int>> checkedVariables;
+	Checked<int> checkedResult;
+	status = compile(withVariables, checked);
+
+	if (status)
+	{
+		bindFuzzVariables(checked.variables(), fuzzCase, checkedVariables);
+		status = evaluate(checked, checkedVariables.data(), checkedResult);
+	}
+
+	log.check(shape, "CheckedInt", withVariables, expected, status, checkedResult.value);
+
+	TypedExpression<int64_t> wide;
+	std::vector<int64_t> wideVariables;
+	int64_t wideResult = 0;
+	status = compile(withVariables, wide);
+
+	if (status)
+	{
+		bindFuzzVariables(wide.variables(), fuzzCase, wideVariables);
+		status = evaluate(wide, wideVariables.data(), wideResult);
+	}
+
+	log.check(shape, "Int64", withVariables, expected, status, static_cast<int>(wideResult));
+
+	TypedExpression<BigInteger> big;
+	std::vector<BigInteger> bigVariables;
+	BigInteger bigResult;
+	status = compile(withVariables, big);
+
+	if (status)
+	{
+		bindFuzzVariables(big.variables(), fuzzCase, bigVariables);
+		status = evaluate(big, bigVariables.data(), bigResult);
 	}
+
+	log.check(shape, "BigInteger", withVariables, expected, status, static_cast<int>(bigResult.smallValue()));
 }
 
-int main()
+/*	Function:	Time a pass over a set of expressions, growing the pass count until the run
+					lasts at least fuzzMinimumSeconds
+	Parameters:	1) Body body	- Callable making one pass
+	Returns:	double - Nanoseconds per pass
+*/
+template <typename Body>
+double timeFuzzPass(Body body)
 {
-	// Int to temporarily store results
-	int result;
+	// Warm up caches & scratch buffers so steady-state behaviour is measured
+	body();
 
-	// Expressions to test evaluate()
-	std::string testExpressions[5] = {
-		"1 + 3",
-		"( 1 + 3 ) * 2",
-		"( 4 / 2 ) + 6",
-		"4 + ( 12 / ( 1 * 2 ) )",
-		"( 1 + ( 12 * 2 )"
-	};
+	size_t passes = 1;
 
-	// Iterate through each expression
-	for (int i = 0; i < 5; i++)
+	while (true)
 	{
-		std::cout << "Evaluating: " << testExpressions[i] << "\n";
+		const auto start = std::chrono::steady_clock::now();
 
-		// If the expression is successfully evaluated
-		if (evaluate(testExpressions[i], result))
+		for (size_t i = 0; i < passes; i++)
 		{
-			std::cout << "Evaluation Successful. Result: " << result << "\n";
+			body();
 		}
 
-		else
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (seconds >= fuzzMinimumSeconds || passes >= 1000000000)
 		{
-			std::cout << "Evaluation Failed.";
+			return seconds * 1e9 / passes;
 		}
-	}
 
-	return 0;
+		const double scale = seconds > 0.0 ? fuzzMinimumSeconds * 1.4 / seconds : 10.0;
+		passes = static_cast<size_t>(passes * std::min(10.0, std::max(2.0, scale)));
+	}
 }
 
+int main(int argc, char** argv)
+{
+	const size_t casesPerShape = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+	const unsigned int seed = argc > 2 ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 1;
+
+	ExpressionGenerator generator(seed);
+	DivergenceLog log;
+	FuzzCase fuzzCase;
+
+	// Differential check over random sizes, small ones included
+	for (size_t shape = 0; shape < fuzzShapeCount; shape++)
+	{
+		for (size_t i = 0; i < casesPerShape; i++)
+		{
+			generator.generate(static_cast<FuzzShape>(shape), generator.next(fuzzMaximumOperators + 1), fuzzCase);
+			checkFuzzCase(static_cast<FuzzShape>(shape), fuzzCase, generator, log);
+		}
+	}
+
+	std::printf("Seed %u: %zu checks over %zu expressions, %zu divergences\n\n", seed, log.checks(),
+		casesPerShape * fuzzShapeCount, log.divergences());
+
+	// Speedup over the string engine, per shape & size, averaged over a set of expressions
+	const size_t setSize = 32;
+	const size_t operatorCounts[3] = { 3, 31, 255 };
+
+	std::printf("%-22s %12s %12s %9s %12s %9s %12s %9s\n", "Shape/operators", "Legacy(ns)", "Evaluate",
+		"speedup", "Compiled", "speedup", "Register", "speedup");
+	std::printf("%s\n", std::string(105, '-').c_str());
+
+	for (size_t shape = 0; shape < fuzzShapeCount; shape++)
+	{
+		for (size_t size = 0; size < 3; size++)
+		{
+			std::vector<std::string> expressions(setSize);
+			std::vector<CompiledExpression> compiled(setSize);
+			std::vector<RegisterProgram> registerPrograms(setSize);
+			std::vector<std::vector<int>> variables(setSize);
+
+			// Compiled forms read every leaf from a variable, so constant folding cannot
+			//		reduce them to a single value
+			for (size_t i = 0; i < setSize; i++)
+			{
+				std::string withVariables;
+				generator.generate(static_cast<FuzzShape>(shape), operatorCounts[size], fuzzCase);
+				renderBracketed(fuzzCase, fuzzCase.nodes.size() - 1, false, expressions[i]);
+				renderCompact(fuzzCase, fuzzCase.nodes.size() - 1, (1u << fuzzLeafCount) - 1, withVariables);
+				compile(withVariables, compiled[i]);
+				registerPrograms[i].lower(compiled[i]);
+				bindFuzzVariables(compiled[i].variables(), fuzzCase, variables[i]);
+			}
+
+			const double legacy = timeFuzzPass([&]
+			{
+				for (size_t i = 0; i < setSize; i++)
+				{
+					int result = 0;
+					evaluateLegacy(expressions[i], result);
+					fuzzSink = result;
+				}
+			});
+
+			const double endToEnd = timeFuzzPass([&]
+			{
+				for (size_t i = 0; i < setSize; i++)
+				{
+					int result = 0;
+					evaluate(expressions[i], result);
+					fuzzSink = result;
+				}
+			});
+
+			const double compiledPass = timeFuzzPass([&]
+			{
+				for (size_t i = 0; i < setSize; i++)
+				{
+					int result = 0;
+					evaluate(compiled[i], variables[i].data(), result);
+					fuzzSink = result;
+				}
+			});
+
+			const double registerPass = timeFuzzPass([&]
+			{
+				for (size_t i = 0; i < setSize; i++)
+				{
+					int result = 0;
+					registerPrograms[i].evaluate(variables[i].data(), result);
+					fuzzSink = result;
+				}
+			});
+
+			const std::string name = std::string(fuzzShapeNames[shape]) + "/" + std::to_string(operatorCounts[size]);
+
+			std::printf("%-22s %12.1f %12.1f %8.1fx %12.1f %8.1fx %12.1f %8.1fx\n", name.c_str(),
+				legacy / setSize, endToEnd / setSize, legacy / endToEnd, compiledPass / setSize,
+				legacy / compiledPass, registerPass / setSize, legacy / registerPass);
+		}
+	}
+
+	return log.divergences() == 0 ? 0 : 1;
+}
+#pragma endregion
+#endif